@@ -0,0 +1,144 @@
+#pragma once
+
+#ifndef LINALG_BENCH_GENERATORS_HXX
+#define LINALG_BENCH_GENERATORS_HXX
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "matrix.hxx"
+
+// Synthetic inputs. Every generator is deterministic for a given seed and
+// produces duplicate-free triplets with nonzero values.
+
+namespace linalg::bench {
+
+    template<typename T>
+    using Triplets = typename linalg::Matrix<T>::COO;
+
+    template<typename T>
+    struct Input {
+        std::string                             structure;
+        Triplets<T>                             triplets;
+    };
+
+    namespace detail {
+
+        template<typename T>
+        T value(std::mt19937_64& rng) {
+            std::uniform_real_distribution<double> magnitude(0.5, 1.5);
+            return static_cast<T>(rng() & 1 ? magnitude(rng) : -magnitude(rng));
+        }
+
+        // Appends `count` distinct sorted columns in [0, n) for row `i`
+        template<typename T>
+        void random_row(Triplets<T>& coo, std::mt19937_64& rng, long long i, std::size_t n, std::size_t count,
+                        std::vector<long long>& scratch) {
+            count = std::min(count, n);
+            scratch.clear();
+
+            // Long rows: selection sampling, one pass over the columns
+            if (count * 4 > n) {
+                std::uniform_real_distribution<double> uniform(0.0, 1.0);
+                for (std::size_t j = 0; j < n && scratch.size() < count; ++j) {
+                    if (uniform(rng) * static_cast<double>(n - j) < static_cast<double>(count - scratch.size())) {
+                        scratch.push_back(static_cast<long long>(j));
+                    }
+                }
+                for (long long j : scratch) coo.add(i, j, value<T>(rng));
+                return;
+            }
+
+            std::uniform_int_distribution<long long> column(0, static_cast<long long>(n) - 1);
+            while (scratch.size() < count) {
+                scratch.push_back(column(rng));
+                if (scratch.size() == count) {
+                    std::sort(scratch.begin(), scratch.end());
+                    scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+                }
+            }
+
+            for (long long j : scratch) coo.add(i, j, value<T>(rng));
+        }
+
+    }
+
+    // |i - j| <= half_width, e.g. finite difference stencils
+    template<typename T>
+    Input<T> banded(std::size_t n, std::size_t half_width, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        Input<T> input{"banded", {}};
+        input.triplets.reserve(n * (2 * half_width + 1));
+
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t first = i > half_width ? i - half_width : 0;
+            std::size_t last = std::min(n - 1, i + half_width);
+
+            for (std::size_t j = first; j <= last; ++j) {
+                input.triplets.add(i, j, detail::value<T>(rng));
+            }
+        }
+
+        input.triplets.n_rows = input.triplets.n_cols = n;
+        return input;
+    }
+
+    // Row lengths follow a Zipf-like law (a few very long rows, most short),
+    // as in web or social graphs; columns are uniform
+    template<typename T>
+    Input<T> power_law(std::size_t n, double mean_row_nnz, std::uint64_t seed, double exponent = 2.1) {
+        std::mt19937_64 rng(seed);
+        Input<T> input{"powerlaw", {}};
+
+        // Pareto with minimum x_m has mean x_m * a / (a - 1), a = exponent - 1
+        double a = exponent - 1.0;
+        double x_m = mean_row_nnz * (a - 1.0) / a;
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        std::vector<long long> scratch;
+        input.triplets.reserve(static_cast<std::size_t>(mean_row_nnz * n));
+
+        for (std::size_t i = 0; i < n; ++i) {
+            double length = x_m / std::pow(1.0 - uniform(rng), 1.0 / a);
+            std::size_t count = std::max<std::size_t>(1, static_cast<std::size_t>(std::min(length, static_cast<double>(n))));
+            detail::random_row<T>(input.triplets, rng, i, n, count, scratch);
+        }
+
+        input.triplets.n_rows = input.triplets.n_cols = n;
+        return input;
+    }
+
+    // Every entry is nonzero with probability `density`
+    template<typename T>
+    Input<T> uniform(std::size_t n, double density, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        Input<T> input{"uniform", {}};
+
+        std::binomial_distribution<std::size_t> row_nnz(n, density);
+        std::vector<long long> scratch;
+        input.triplets.reserve(static_cast<std::size_t>(density * n * n));
+
+        for (std::size_t i = 0; i < n; ++i) detail::random_row<T>(input.triplets, rng, i, n, row_nnz(rng), scratch);
+
+        input.triplets.n_rows = input.triplets.n_cols = n;
+        return input;
+    }
+
+    // Dense rows of the triplets, the input of `init_crs` / `init_ccs`
+    template<typename T>
+    std::vector<std::vector<T>> to_rows(const Triplets<T>& coo) {
+        std::vector<std::vector<T>> rows(coo.n_rows, std::vector<T>(coo.n_cols, static_cast<T>(0)));
+
+        for (std::size_t k = 0; k < coo.values.size(); ++k) {
+            rows[coo.row_indexes[k]][coo.col_indexes[k]] = coo.values[k];
+        }
+        return rows;
+    }
+
+}
+
+#endif // LINALG_BENCH_GENERATORS_HXX
@@ -0,0 +1,262 @@
+#pragma once
+
+#ifndef LINALG_BENCH_HARNESS_HXX
+#define LINALG_BENCH_HARNESS_HXX
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/resource.h>
+#include "../src/diagnostics/metrics.hxx"
+#include "../src/parallel/thread_pool.hxx"
+
+// Timing, memory and JSON reporting for the benchmark executable.
+//
+// A case repeats a batch of operations until its time budget runs out. Each
+// batch yields one latency sample (batch time / batch size); cheap operations
+// use large batches so the clock overhead stays negligible. Throughput is the
+// total operation count over the total measured time.
+
+namespace linalg::bench {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        // Minimum measured time per case
+        double                                  budget_seconds = 0.25;
+        // Smaller inputs and budgets, for smoke runs
+        bool                                    quick = false;
+        // Only cases whose name contains this substring run
+        std::string                             filter;
+        // Output file; empty writes the report to stdout
+        std::string                             output;
+        std::uint64_t                           seed = 42;
+    };
+
+    // Input description copied into every result
+    struct Shape {
+        std::string                             structure;
+        std::string                             format;
+        std::size_t                             rows = 0;
+        std::size_t                             cols = 0;
+        std::size_t                             nnz = 0;
+    };
+
+    struct Result {
+        std::string                             name;
+        Shape                                   shape;
+        std::size_t                             ops = 0;
+        double                                  seconds = 0;
+        // Per-operation latency over the samples, nanoseconds
+        double                                  p50 = 0, p90 = 0, p99 = 0, max = 0;
+        // Items per operation (nonzeros, elements, flops...) and their unit
+        double                                  items_per_op = 0;
+        std::string                             item_unit;
+        // High-water mark of the resident set during the case, KiB. Only
+        // measured per case when the peak could be reset before it.
+        long                                    peak_rss_kb = 0;
+        bool                                    per_case_rss = false;
+        linalg::metrics::Snapshot               metrics;
+    };
+
+    // Peak resident set size of the process, KiB
+    inline long peak_rss_kb() {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+
+        while (std::getline(status, line)) {
+            if (line.rfind("VmHWM:", 0) == 0) return std::stol(line.substr(6));
+        }
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    // Restarts the peak RSS from the current RSS, so the next reading covers
+    // one case only. False when the kernel refused (no permission, or older
+    // than 4.0): the peak is then the process-wide one.
+    inline bool reset_peak_rss() {
+        std::ofstream clear("/proc/self/clear_refs");
+        return static_cast<bool>(clear << "5" << std::flush);
+    }
+
+    inline double percentile(const std::vector<double>& sorted, double q) {
+        if (sorted.empty()) return 0;
+        std::size_t rank = static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+
+    class Suite {
+    public:
+        explicit Suite(Options _options) : options(std::move(_options)) {}
+
+        const Options& settings() const { return options; }
+
+        bool selected(const std::string& name) const {
+            return options.filter.empty() || name.find(options.filter) != std::string::npos;
+        }
+
+        // Runs `op(k)` for k = 0, 1, ... in batches of `batch` until the budget
+        // is spent. `setup()` runs before every batch outside of the timed region.
+        // A zero `batch` is calibrated so that one batch takes about a millisecond.
+        template<typename Op, typename Setup>
+        void run(const std::string& name, const Shape& shape, std::size_t batch,
+                 double items_per_op, const std::string& item_unit, Op&& op, Setup&& setup) {
+            if (!selected(name + "/" + shape.structure + "/" + shape.format)) return;
+
+            std::size_t k = 0;
+
+            // Warm-up: first-touch allocations and lazily built formats
+            if (batch == 0) {
+                for (batch = 1; batch < (std::size_t(1) << 20); batch *= 2) {
+                    setup();
+
+                    auto start = Clock::now();
+                    for (std::size_t b = 0; b < batch; ++b) op(k++);
+                    if (std::chrono::duration<double>(Clock::now() - start).count() >= 1e-3) break;
+                }
+            }
+            else {
+                setup();
+                for (std::size_t b = 0; b < batch; ++b) op(k++);
+            }
+
+            // Keep the process-wide peak, which includes input generation
+            process_peak_kb = std::max(process_peak_kb, peak_rss_kb());
+            bool per_case_rss = reset_peak_rss();
+            linalg::metrics::reset();
+
+            std::vector<double> samples;
+            double total = 0;
+
+            while (total < options.budget_seconds || samples.size() < 3) {
+                setup();
+
+                auto start = Clock::now();
+                for (std::size_t b = 0; b < batch; ++b) op(k++);
+                double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+                total += elapsed;
+                samples.push_back(elapsed * 1e9 / static_cast<double>(batch));
+            }
+
+            Result result;
+            result.name = name;
+            result.shape = shape;
+            result.ops = samples.size() * batch;
+            result.seconds = total;
+            result.items_per_op = items_per_op;
+            result.item_unit = item_unit;
+            result.metrics = linalg::metrics::snapshot();
+            result.peak_rss_kb = peak_rss_kb();
+            result.per_case_rss = per_case_rss;
+            process_peak_kb = std::max(process_peak_kb, result.peak_rss_kb);
+
+            std::sort(samples.begin(), samples.end());
+            result.p50 = percentile(samples, 0.50);
+            result.p90 = percentile(samples, 0.90);
+            result.p99 = percentile(samples, 0.99);
+            result.max = samples.back();
+
+            std::fprintf(stderr, "%-20s %-13s %-4s %12.0f ops/s  p50 %10.0f ns\n", name.c_str(),
+                         shape.structure.c_str(), shape.format.c_str(),
+                         static_cast<double>(result.ops) / result.seconds, result.p50);
+
+            results.push_back(std::move(result));
+        }
+
+        template<typename Op>
+        void run(const std::string& name, const Shape& shape, std::size_t batch,
+                 double items_per_op, const std::string& item_unit, Op&& op) {
+            run(name, shape, batch, items_per_op, item_unit, std::forward<Op>(op), [] {});
+        }
+
+        std::string json() const;
+
+    private:
+        Options                                 options;
+        std::vector<Result>                     results;
+        long                                    process_peak_kb = 0;
+    };
+
+    inline std::string escape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    inline std::string Suite::json() const {
+        std::ostringstream out;
+        out.precision(6);
+
+        out << "{\n";
+        out << "  \"schema\": \"linalg-bench/1\",\n";
+        out << "  \"threads\": " << linalg::parallel::pool().size() << ",\n";
+        out << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n";
+        out << "  \"seed\": " << options.seed << ",\n";
+        out << "  \"metrics_enabled\": " << (LINALG_METRICS ? "true" : "false") << ",\n";
+#ifdef __VERSION__
+        out << "  \"compiler\": \"" << escape(__VERSION__) << "\",\n";
+#endif
+        // Whether every case reports its own peak; a case whose reset failed
+        // leaves out `peak_rss_kb`, the process-wide peak is the one above
+        bool per_case_rss = std::all_of(results.begin(), results.end(),
+                                        [](const Result& res) { return res.per_case_rss; });
+
+        out << "  \"peak_rss_kb\": " << std::max(process_peak_kb, peak_rss_kb()) << ",\n";
+        out << "  \"per_case_rss\": " << (per_case_rss ? "true" : "false") << ",\n";
+        out << "  \"benchmarks\": [";
+
+        for (std::size_t r = 0; r < results.size(); ++r) {
+            const Result& res = results[r];
+            double ops_per_sec = static_cast<double>(res.ops) / res.seconds;
+
+            out << (r == 0 ? "\n" : ",\n");
+            out << "    {\"name\": \"" << escape(res.name) << "\", "
+                << "\"structure\": \"" << escape(res.shape.structure) << "\", "
+                << "\"format\": \"" << escape(res.shape.format) << "\", "
+                << "\"rows\": " << res.shape.rows << ", \"cols\": " << res.shape.cols << ", "
+                << "\"nnz\": " << res.shape.nnz << ",\n"
+                << "     \"ops\": " << res.ops << ", \"seconds\": " << res.seconds << ", "
+                << "\"ops_per_sec\": " << ops_per_sec << ", ";
+
+            if (!res.item_unit.empty()) {
+                out << "\"" << escape(res.item_unit) << "_per_sec\": " << ops_per_sec * res.items_per_op << ", ";
+            }
+
+            out << "\n     \"latency_ns\": {\"p50\": " << res.p50 << ", \"p90\": " << res.p90
+                << ", \"p99\": " << res.p99 << ", \"max\": " << res.max << "}";
+
+            if (res.per_case_rss) out << ", \"peak_rss_kb\": " << res.peak_rss_kb;
+
+            if (LINALG_METRICS) {
+                out << ",\n     \"counters\": {";
+                for (std::size_t c = 0; c < linalg::metrics::COUNTER_COUNT; ++c) {
+                    auto counter = static_cast<linalg::metrics::Counter>(c);
+                    out << (c == 0 ? "" : ", ") << "\"" << linalg::metrics::name(counter) << "\": "
+                        << res.metrics.counters[c];
+                }
+                out << "}";
+            }
+
+            out << "}";
+        }
+
+        out << "\n  ]\n}\n";
+        return out.str();
+    }
+
+}
+
+#endif // LINALG_BENCH_HARNESS_HXX
@@ -0,0 +1,270 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "matrix.hxx"
+#include "harness.hxx"
+#include "generators.hxx"
+
+// Benchmark suite: construction, element access, mutation and the multiply
+// kernels over every `matrix_state`, on synthetic inputs.
+//
+//   linalg_bench [--quick] [--filter <substring>] [--output <file.json>]
+//                [--seed <n>] [--budget <seconds>]
+
+namespace {
+
+    using T = double;
+    using linalg::Format;
+    using linalg::bench::Input;
+    using linalg::bench::Shape;
+    using linalg::bench::Suite;
+
+    constexpr Format STATES[] = {Format::Dense, Format::CRS, Format::CCS, Format::COO, Format::All};
+    constexpr Format SPARSE_STATES[] = {Format::CRS, Format::CCS, Format::COO};
+
+    Shape shape_of(const Input<T>& input, Format format) {
+        return Shape{input.structure, linalg::format_name(format), static_cast<std::size_t>(input.triplets.n_rows),
+                     static_cast<std::size_t>(input.triplets.n_cols), input.triplets.values.size()};
+    }
+
+    // Positions visited by the access cases: uniform over the matrix, or
+    // row-major starting from the top left corner
+    std::vector<std::pair<int, int>> positions(std::size_t n, bool random, std::uint64_t seed) {
+        constexpr std::size_t COUNT = 1 << 16;
+        std::vector<std::pair<int, int>> out(COUNT);
+
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<int> index(0, static_cast<int>(n) - 1);
+
+        for (std::size_t k = 0; k < COUNT; ++k) {
+            out[k] = random ? std::make_pair(index(rng), index(rng))
+                            : std::make_pair(static_cast<int>(k / n % n), static_cast<int>(k % n));
+        }
+        return out;
+    }
+
+    void construction(Suite& suite, const Input<T>& input) {
+        Shape shape = shape_of(input, Format::Dynamic);
+        auto rows = linalg::bench::to_rows<T>(input.triplets);
+        T sink = 0;
+
+        shape.format = "CRS";
+        suite.run("construct/init_crs", shape, 1, shape.nnz, "nnz",
+                  [&](std::size_t) { sink += linalg::Matrix<T>::init_crs(rows).values.size(); });
+
+        shape.format = "CCS";
+        suite.run("construct/init_ccs", shape, 1, shape.nnz, "nnz",
+                  [&](std::size_t) { sink += linalg::Matrix<T>::init_ccs(rows).values.size(); });
+
+        for (Format state : STATES) {
+            suite.run("construct/from_coo", shape_of(input, state), 1, shape.nnz, "nnz",
+                      [&](std::size_t) { sink += linalg::Matrix<T>(input.triplets, state).get_rows(); });
+        }
+
+        if (sink < 0) std::cerr << sink;
+    }
+
+    // A mutation writes a value and the next one restores the previous value,
+    // so the sparse formats alternate between an insert and an erase and the
+    // matrix stays the same size for the whole case.
+    void access(Suite& suite, const Input<T>& input, std::uint64_t seed) {
+        std::size_t n = static_cast<std::size_t>(input.triplets.n_rows);
+
+        for (bool random : {true, false}) {
+            auto where = positions(n, random, seed);
+            std::string order = random ? "random" : "sequential";
+
+            for (Format state : STATES) {
+                linalg::Matrix<T> A(input.triplets, state);
+                Shape shape = shape_of(input, state);
+                T sink = 0;
+
+                suite.run("get/" + order, shape, 0, 1, "", [&](std::size_t k) {
+                    const auto& [i, j] = where[k % where.size()];
+                    sink += A.get(i, j);
+                });
+
+                T previous = 0;
+                suite.run("set/" + order, shape, 0, 1, "", [&](std::size_t k) {
+                    const auto& [i, j] = where[k / 2 % where.size()];
+                    if (k % 2 == 0) {
+                        previous = A.get(i, j);
+                        A.set(i, j, static_cast<T>(0.5) + previous);
+                    }
+                    else {
+                        A.set(i, j, previous);
+                    }
+                });
+
+                if (sink == static_cast<T>(-1)) std::cerr << sink;
+            }
+        }
+    }
+
+    void printing(Suite& suite, std::uint64_t seed) {
+        // `CRS::print` renders at most 20 columns
+        for (std::size_t n : {8, 20}) {
+            Input<T> input = linalg::bench::uniform<T>(n, 0.25, seed);
+            linalg::Matrix<T> A(input.triplets, Format::CRS);
+            std::size_t bytes = 0;
+
+            suite.run("print/crs", shape_of(input, Format::CRS), 0, 1, "",
+                      [&](std::size_t) { bytes += A.crs().print().size(); });
+
+            if (bytes == 0) std::cerr << "empty print\n";
+        }
+    }
+
+    void sparse_kernels(Suite& suite, const Input<T>& input, std::uint64_t seed) {
+        std::size_t n = static_cast<std::size_t>(input.triplets.n_rows);
+        double nnz = static_cast<double>(input.triplets.values.size());
+        constexpr std::size_t RHS = 8;
+
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<T> uniform(-1, 1);
+
+        std::vector<T> x(n);
+        for (auto& value : x) value = uniform(rng);
+
+        std::vector<std::vector<T>> block(n, std::vector<T>(RHS));
+        for (auto& row : block) for (auto& value : row) value = uniform(rng);
+        linalg::Matrix<T> X(block, Format::Dense);
+        block.clear();
+
+        for (Format state : SPARSE_STATES) {
+            // COO products read the lazily cached CRS
+            linalg::Matrix<T> A(input.triplets, state);
+            Shape shape = shape_of(input, state);
+            T sink = 0;
+
+            suite.run("spmv", shape, 0, 2 * nnz, "flops", [&](std::size_t) { sink += (A * x)[0]; });
+            suite.run("spmv/transpose", shape, 0, 2 * nnz, "flops",
+                      [&](std::size_t) { sink += A.transpose_multiply(x)[0]; });
+            suite.run("spmm/8", shape, 0, 2 * nnz * RHS, "flops",
+                      [&](std::size_t) { sink += (A * X).get(0, 0); });
+
+            if (sink == static_cast<T>(-1)) std::cerr << sink;
+        }
+
+        // Format conversion behind the cache: every batch starts from a copy
+        // that has only its authoritative CRS
+        linalg::Matrix<T> source(input.triplets, Format::CRS);
+        linalg::Matrix<T> fresh;
+        std::size_t built = 0;
+
+        suite.run("convert/crs_to_ccs", shape_of(input, Format::CRS), 1, nnz, "nnz",
+                  [&](std::size_t) { built += fresh.ccs().values.size(); },
+                  [&] { fresh = source; });
+        suite.run("convert/crs_to_coo", shape_of(input, Format::CRS), 1, nnz, "nnz",
+                  [&](std::size_t) { built += fresh.coo().values.size(); },
+                  [&] { fresh = source; });
+
+        if (built == 0) std::cerr << "empty conversion\n";
+    }
+
+    void dense_kernels(Suite& suite, std::size_t n, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::uniform_real_distribution<T> uniform(-1, 1);
+
+        std::vector<std::vector<T>> rows(n, std::vector<T>(n));
+        for (auto& row : rows) for (auto& value : row) value = uniform(rng);
+
+        linalg::Matrix<T> A(rows, Format::Dense);
+        linalg::Matrix<T> B(rows, Format::Dense);
+        std::vector<T> x(n, static_cast<T>(1));
+
+        Shape shape{"dense", "def", n, n, n * n};
+        double size = static_cast<double>(n);
+        T sink = 0;
+
+        suite.run("gemv", shape, 0, 2 * size * size, "flops", [&](std::size_t) { sink += (A * x)[0]; });
+        suite.run("gemm", shape, 0, 2 * size * size * size, "flops",
+                  [&](std::size_t) { sink += (A * B).get(0, 0); });
+
+        if (sink == static_cast<T>(-1)) std::cerr << sink;
+    }
+
+    int usage(const char* program) {
+        std::cerr << "Usage: " << program
+                  << " [--quick] [--filter <substring>] [--output <file.json>] [--seed <n>] [--budget <seconds>]\n";
+        return 2;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    linalg::bench::Options options;
+    bool budget_set = false;
+
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        bool has_value = a + 1 < argc;
+
+        if (arg == "--quick") options.quick = true;
+        else if (arg == "--filter" && has_value) options.filter = argv[++a];
+        else if (arg == "--output" && has_value) options.output = argv[++a];
+        else if (arg == "--seed" && has_value) options.seed = std::strtoull(argv[++a], nullptr, 10);
+        else if (arg == "--budget" && has_value) {
+            options.budget_seconds = std::strtod(argv[++a], nullptr);
+            budget_set = true;
+        }
+        else return usage(argv[0]);
+    }
+
+    if (options.quick && !budget_set) options.budget_seconds = 0.02;
+
+    // Element access runs on matrices the dense states can hold, the sparse
+    // kernels on matrices they cannot
+    std::size_t access_n = options.quick ? 300 : 2000;
+    std::size_t kernel_n = options.quick ? 20000 : 200000;
+    std::size_t gemm_n = options.quick ? 128 : 512;
+    std::uint64_t seed = options.seed;
+
+    Suite suite(options);
+
+    {
+        std::vector<Input<T>> inputs;
+        inputs.push_back(linalg::bench::uniform<T>(access_n, 0.005, seed));
+        inputs.push_back(linalg::bench::uniform<T>(access_n, 0.05, seed + 1));
+        inputs[0].structure = "uniform-0.5%";
+        inputs[1].structure = "uniform-5%";
+        inputs.push_back(linalg::bench::banded<T>(access_n, 5, seed + 2));
+        inputs.push_back(linalg::bench::power_law<T>(access_n, 10, seed + 3));
+
+        for (const auto& input : inputs) construction(suite, input);
+        for (const auto& input : inputs) access(suite, input, seed);
+    }
+
+    printing(suite, seed);
+
+    {
+        std::vector<Input<T>> inputs;
+        inputs.push_back(linalg::bench::uniform<T>(kernel_n, 16.0 / static_cast<double>(kernel_n), seed));
+        inputs.push_back(linalg::bench::banded<T>(kernel_n, 8, seed + 1));
+        inputs.push_back(linalg::bench::power_law<T>(kernel_n, 16, seed + 2));
+
+        for (const auto& input : inputs) sparse_kernels(suite, input, seed);
+    }
+
+    dense_kernels(suite, gemm_n, seed);
+
+    std::string report = suite.json();
+
+    if (options.output.empty()) {
+        std::cout << report;
+        return 0;
+    }
+
+    std::ofstream out(options.output);
+    if (!(out << report)) {
+        std::cerr << "Failed to write " << options.output << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -10,8 +10,28 @@
 #include "spdlog/spdlog.h"
 
 namespace linalg {
-    template <typename T>
-    class Matrix;  
+    // Storage format of a matrix.
+    // `Dynamic` selects the runtime-dispatched `Matrix<T>`, whose state is one of
+    // Dense ("def"), CRS, CCS, COO or All ("all"). The state is the one
+    // authoritative format; the others are built on first use and cached until
+    // the next write. All keeps the dense buffer authoritative and serves the
+    // sparse products from those caches.
+    enum class Format {
+        Dynamic,
+        Dense,
+        CRS,
+        CCS,
+        COO,
+        All
+    };
+
+    template <typename T, Format F = Format::Dynamic, typename I = long long>
+    class Matrix;
+
+    namespace expr {
+        template <typename T>
+        class MatrixLeaf;
+    }
 };
 
 #endif //LINEAR_ALGEBRA_HXX
@@ -6,12 +6,25 @@
 #include <vector>
 #include <string>
 #include <initializer_list>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
 #include "linalg.hxx"
+#include "../../src/matrix/aligned_allocator.hxx"
+#include "../../src/matrix/sparse_array.hxx"
+#include "../../src/matrix/format.hxx"
+#include "../../src/matrix/format_storage.hxx"
+#include "../../src/diagnostics/log.hxx"
+#include "../../src/diagnostics/metrics.hxx"
+#include "../../src/expressions/expression.hxx"
 
 namespace linalg {
 
+    // Runtime-dispatched matrix: the format is chosen when the matrix is built
+    // (the `sparse` argument) and every operation switches on it.
+    // See `Matrix<T, F, I>` below for the compile-time counterpart.
     template<typename T>
-    class Matrix {
+    class Matrix<T, Format::Dynamic, long long> {
     public:
         // Structs
         struct CRS;
@@ -21,6 +34,7 @@ namespace linalg {
         // Constructors
         Matrix();
         Matrix(const Matrix<T>& _oth);
+        Matrix(Matrix<T>&& _oth) noexcept;
 
         // Guide for 'sparse' string
         // "CRS" / "CSR"
@@ -30,25 +44,40 @@ namespace linalg {
         // "all"
         Matrix(const std::vector<std::vector<T>>& _oth, const std::string& sparse);
         explicit Matrix(std::initializer_list<std::initializer_list<T>> init_matrix, const std::string& sparse);
+        // Builds the requested format straight from assembled triplets
+        Matrix(const COO& _coo, const std::string& sparse);
+
+        // Same as above with the format given directly
+        Matrix(const std::vector<std::vector<T>>& _oth, Format format);
+        explicit Matrix(std::initializer_list<std::initializer_list<T>> init_matrix, Format format);
+        Matrix(const COO& _coo, Format format);
+        // Converts a matrix of a compile-time format
+        template<Format F, typename I>
+        explicit Matrix(const Matrix<T, F, I>& _oth);
+        // Evaluates a lazy elementwise expression (`A + B * 2.0 - C`)
+        template<linalg::expr::Node E>
+        Matrix(const E& _expr);
 
         // Destructor
         ~Matrix();
 
-        // Operations
-        Matrix<T> operator+();
-        Matrix<T> operator-();
+        // Assignment
+        Matrix<T>& operator=(const Matrix<T>& _oth);
+        Matrix<T>& operator=(Matrix<T>&& _oth) noexcept;
+        template<linalg::expr::Node E>
+        Matrix<T>& operator=(const E& _expr);
 
+        // Operations
+        // Elementwise `+`, `-`, unary minus and scalar `*` with Matrix or
+        // expression operands build lazy expressions, see src/expressions/expression.hxx
         Matrix<T> operator+(const std::vector<std::vector<T>>& _oth) const;
-        Matrix<T> operator+(const Matrix<T>& _oth) const;
-        Matrix<T> operator+(const long double& scalar) const;
-
         Matrix<T> operator-(const std::vector<std::vector<T>>& _oth) const;
-        Matrix<T> operator-(const Matrix<T>& _oth) const;
-        Matrix<T> operator-(const long double& scalar) const;
 
         Matrix<T> operator*(const std::vector<std::vector<T>>& _oth) const;
         Matrix<T> operator*(const Matrix<T>& _oth) const;
-        Matrix<T> operator*(const long double& scalar) const;
+
+        // Matrix-vector product y = A * x
+        std::vector<T> operator*(const std::vector<T>& x) const;
 
         // Matrix<T> operator/(const std::vector<std::vector<T>>& _oth) const;
         // Matrix<T> operator/(const Matrix<T>& _oth) const;
@@ -59,29 +88,107 @@ namespace linalg {
         static CCS init_ccs(const std::vector<std::vector<T>> _matrix);
         static COO init_coo(const std::vector<std::vector<T>> _matrix);
 
-        T& get(int i, int j);
+        // Transposed matrix-vector product y = A^T * x
+        std::vector<T> transpose_multiply(const std::vector<T>& x) const;
+
+        // Reads never touch the cached formats; every write goes through `set`
+        T get(int i, int j) const;
 
         void set(int i, int j, const T& _val);
 
-        std::string print();
+        std::string print() const;
+
+        int get_rows() const { return rows; };
+        int get_cols() const { return cols; };
+        Format get_format() const { return matrix_state; };
+
+        // Format views. Only the format the matrix was built in is stored;
+        // the others are materialized on first use (never through the dense
+        // buffer, CRS <-> CCS is a parallel transpose) and cached until the
+        // next write. "all" keeps the dense buffer authoritative and runs
+        // products on the cached CRS / CCS. Const use (products, reads,
+        // these views) is safe from several threads at once: a missing format
+        // is built once under a lock. Writes need exclusive access as usual.
+        const CRS& crs() const;
+        const CCS& ccs() const;
+        const COO& coo() const;
 
-        void update_rows() { rows = matrix.size(); };
-        void update_cols() { cols = matrix[0].size(); };
+        // Files
+        // Native binary layout, "CRS" or "CCS" (see src/io/binary_format.hxx)
+        void save_binary(const std::string& path, const std::string& sparse = "CRS") const;
+        // Maps a file written by `save_binary` read-only; the arrays are used in
+        // place until the matrix is first modified, which copies them. `validate`
+        // checks the pointers and indexes in one pass, skip it for trusted files
+        // to open in constant time.
+        static Matrix<T> open_binary(const std::string& path, bool validate = true);
+        // Streams a Matrix Market coordinate file into the `sparse` format
+        static Matrix<T> read_matrix_market(const std::string& path, const std::string& sparse = "CRS");
 
 
     protected:
 
     private:
-        mutable std::vector<std::vector<T>>     matrix;
+        template<typename> friend class linalg::expr::MatrixLeaf;
+        template<typename, Format, typename> friend class Matrix;
+
+        // Single pass evaluation of an expression into this matrix
+        template<linalg::expr::Node E>
+        void assign_expression(const E& _expr);
+
+        using DenseBuffer = std::vector<T, linalg::detail::AlignedAllocator<T>>;
+
+        // Copies `_matrix` into the dense buffer and updates the dimensionality
+        void load_dense(const std::vector<std::vector<T>>& _matrix);
+        // Builds the authoritative format (`matrix_state`) from `_matrix`
+        void load_format(const std::vector<std::vector<T>>& _matrix);
+        // Resizes the dense buffer to `_rows` x `_cols` zeros
+        void reshape_dense(int _rows, int _cols);
+        // Makes the dense buffer current (a no-op when it is authoritative)
+        void sync_dense() const;
+        // Nonzeros of the authoritative format as triplets
+        COO collect_triplets() const;
+        // Format the other ones are derived from ("all" is backed by dense)
+        Format authority() const;
+        // Whether `format` is authoritative or cached from the current version
+        bool is_current(Format format) const;
+        // Called after every write: bumps the version and frees the caches
+        void invalidate_caches();
+        // Throws `std::out_of_range` unless (i, j) lies inside the matrix
+        void check_bounds(int i, int j) const;
+        // Matrix of the given shape in `state` with no storage allocated yet
+        static Matrix<T> sparse_shell(long long _rows, long long _cols, Format state);
+
+        // Dense storage: one aligned row-major buffer, element (i, j) lives at
+        // `matrix[i * ld + j]`. Rows are padded to `ld` so each starts aligned.
+        mutable DenseBuffer                     matrix;
+        // Leading dimension (row stride) of `matrix`
+        mutable std::size_t                     ld;
         // CRS (Compressed Row Storage) / CSR (Compressed Sparse Row)
         mutable CRS                             crs_matrix;
         // CCS (Compressed Column Storage) / CSC (Compressed Sparse Column)
         mutable CCS                             ccs_matrix;
         // COO (Coordinate List)
         mutable COO                             coo_matrix;
-        // `matrix_state`:
-        // "CRS" / "CCS" / "COO" / "def" / "all"
-        std::string                             matrix_state;
+        // Active format: Dense / CRS / CCS / COO / All
+        Format                                  matrix_state;
+
+        // Version of the authoritative format, bumped on every write.
+        // A cached format is current when its entry in `cached` matches;
+        // the entry is published (release) after the format is built.
+        std::uint64_t                           version = 1;
+        struct CachedVersions {
+            std::atomic<std::uint64_t>          dense{0};
+            std::atomic<std::uint64_t>          crs{0};
+            std::atomic<std::uint64_t>          ccs{0};
+            std::atomic<std::uint64_t>          coo{0};
+
+            CachedVersions() = default;
+            CachedVersions(const CachedVersions& _oth) { *this = _oth; }
+            CachedVersions& operator=(const CachedVersions& _oth);
+        };
+        mutable CachedVersions                  cached;
+        // Serializes the cache builds of const methods; never copied
+        mutable std::mutex                      cache_mutex;
 
         mutable int                             rows;
         mutable int                             cols;
@@ -89,28 +196,46 @@ namespace linalg {
 
     template<typename T>
     struct Matrix<T>::CRS {
-        std::vector<T>                          values;
-        std::vector<long long>                  col_indexes;
-        std::vector<long long>                  row_pointers;
+        // Owned, or borrowed from a mapped file (see `open_binary`)
+        linalg::detail::SparseArray<T>          values;
+        linalg::detail::SparseArray<long long>  col_indexes;
+        linalg::detail::SparseArray<long long>  row_pointers;
 
-        std::string print();
+        std::string print() const;
 
-        // Matrix-like value receiving/setting
-        T& operator()(int i, int j);
+        // Matrix-like value receiving/setting; writes only go through `set`
         const T& operator()(int i, int j) const;
         void set(int i, int j, const T& value);
+
+    private:
+        friend class Matrix<T>;
+
+        // Sparse products: y = A * x (`x` holds one entry per column)
+        // and Y = A * X for a dense X with one row per column of A.
+        // The arrays carry no column count, so `Matrix` checks the operand
+        // dimensions before calling these
+        std::vector<T> multiply(const std::vector<T>& x) const;
+        Matrix<T> multiply(const Matrix<T>& X) const;
     };
 
     template<typename T>
     struct Matrix<T>::CCS {
-        std::vector<T>                          values;
-        std::vector<long long>                  col_pointers;
-        std::vector<long long>                  row_indexes;
+        linalg::detail::SparseArray<T>          values;
+        linalg::detail::SparseArray<long long>  col_pointers;
+        linalg::detail::SparseArray<long long>  row_indexes;
 
-        // Matrix-like value receiving/setting
-        T& operator()(int i, int j);
+        // Matrix-like value receiving/setting; writes only go through `set`
         const T& operator()(int i, int j) const;
         void set(int i, int j, const T& _val);
+
+    private:
+        friend class Matrix<T>;
+
+        // Transposed sparse products: y = A^T * x (`x` holds one entry per row)
+        // and Y = A^T * X for a dense X with one row per row of A.
+        // Dimensions are checked by `Matrix`, as for `CRS::multiply`
+        std::vector<T> transpose_multiply(const std::vector<T>& x) const;
+        Matrix<T> transpose_multiply(const Matrix<T>& X) const;
     };
 
     template<typename T>
@@ -119,19 +244,102 @@ namespace linalg {
         std::vector<long long>                  col_indexes;
         std::vector<long long>                  row_indexes;
 
-        // Matrix-like value receiving/setting
-        T& operator()(int i, int j);
+        // Dimensionality; grows as triplets outside of it are added
+        long long                               n_rows = 0;
+        long long                               n_cols = 0;
+
+        // Triplets sharing a position are summed, as in assembly.
+        // `operator()` refers to the first stored triplet at (i, j);
+        // `set` leaves one triplet there, or none for a zero value.
         const T& operator()(int i, int j) const;
         void set(int i, int j, const T& _val);
+
+        // Assembly: appends a triplet in amortized O(1)
+        void add(long long i, long long j, const T& _val);
+        void reserve(std::size_t nnz);
+
+        // Conversion by counting sort on the outer index followed by a
+        // per-slice sort on the inner one, both run on the thread pool.
+        // `sum_duplicates = false` skips the merge and stores repeated
+        // positions as separate entries.
+        CRS to_crs(bool sum_duplicates = true) const;
+        CCS to_ccs(bool sum_duplicates = true) const;
+    };
+
+    // Matrix with the storage format and index type fixed at compile time,
+    // e.g. `Matrix<double, Format::CRS, std::int32_t>`. It holds exactly one
+    // representation (Dense, CRS, CCS or COO) and every operation resolves
+    // its format statically. 32-bit indexes halve the index traffic of the
+    // sparse kernels. `Matrix<T>` is the runtime-dispatched counterpart.
+    template<typename T, Format F, typename I>
+    class Matrix {
+        static_assert(F == Format::Dense || F == Format::CRS || F == Format::CCS || F == Format::COO,
+                      "A compile-time format must be Dense, CRS, CCS or COO");
+        static_assert(std::is_integral_v<I> && std::is_signed_v<I>, "Index type must be a signed integer");
+
+    public:
+        using value_type = T;
+        using index_type = I;
+        static constexpr Format format = F;
+        static constexpr bool compressed = F == Format::CRS || F == Format::CCS;
+
+        // Constructors
+        Matrix();
+        // Zero matrix of the given dimensionality
+        Matrix(I _rows, I _cols);
+        Matrix(const std::vector<std::vector<T>>& _oth);
+        explicit Matrix(std::initializer_list<std::initializer_list<T>> init_matrix);
+        explicit Matrix(const typename Matrix<T>::COO& _coo);
+        explicit Matrix(const Matrix<T>& _oth);
+
+        // Runtime-dispatched copy in the same format
+        Matrix<T> to_dynamic() const;
+
+        // Methods
+        T get(I i, I j) const;
+        void set(I i, I j, const T& _val);
+
+        I get_rows() const { return rows; };
+        I get_cols() const { return cols; };
+        // Stored entries (every element for Dense)
+        std::size_t nnz() const;
+
+        // y = A * x and y = A^T * x
+        std::vector<T> operator*(const std::vector<T>& x) const;
+        std::vector<T> transpose_multiply(const std::vector<T>& x) const;
+
+        // Raw storage, see src/matrix/format_storage.hxx
+        const linalg::detail::format_storage_t<T, F, I>& storage() const { return data; };
+
+    private:
+        template<typename, Format, typename> friend class Matrix;
+
+        // Builds the storage from triplets with `long long` indexes
+        void load_triplets(const typename Matrix<T>::COO& _coo);
+        // Triplets of the stored entries, as used by the runtime matrix
+        typename Matrix<T>::COO collect_triplets() const;
+        void check_bounds(I i, I j) const;
+
+        linalg::detail::format_storage_t<T, F, I>   data;
+
+        I                                           rows = 0;
+        I                                           cols = 0;
     };
 
 }
 
+#include "../../src/kernels/gemm.hxx"
+#include "../../src/kernels/spmv.hxx"
+#include "../../src/kernels/transpose.hxx"
 #include "../../src/matrix/matrix_constructors.hxx"
 #include "../../src/matrix/matrix_operations.hxx"
+#include "../../src/matrix/matrix_cache.hxx"
 #include "../../src/matrix/matrix_operators.hxx"
+#include "../../src/matrix/matrix_expressions.hxx"
+#include "../../src/matrix/matrix_io.hxx"
 #include "../../src/sparsemtxes/crs.hxx"
 #include "../../src/sparsemtxes/ccs.hxx"
 #include "../../src/sparsemtxes/coo.hxx"
+#include "../../src/matrix/matrix_formats.hxx"
 
 #endif // DEFINITION_MATRIX_HXX
\ No newline at end of file
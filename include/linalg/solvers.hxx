@@ -0,0 +1,11 @@
+#pragma once
+
+#ifndef DEFINITION_SOLVERS_HXX
+#define DEFINITION_SOLVERS_HXX
+
+#include "matrix.hxx"
+#include "../../src/solvers/solver.hxx"
+#include "../../src/solvers/preconditioners.hxx"
+#include "../../src/solvers/krylov.hxx"
+
+#endif // DEFINITION_SOLVERS_HXX
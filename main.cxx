@@ -1,3 +1,4 @@
+#include <cstdlib>
 #include <iostream>
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/basic_file_sink.h"
@@ -5,9 +6,12 @@
 #include "include/linalg/matrix.hxx"
 
 int main() {
+    // Relative to the working directory unless LINALG_LOG_FILE says otherwise
+    const char* log_file = std::getenv("LINALG_LOG_FILE");
+
     auto file_logger = spdlog::basic_logger_mt(
-        "global_logger", \
-        "/home/uylag/LINALG/logs/math.log"
+        "global_logger",
+        log_file ? log_file : "logs/math.log"
     );
 
     spdlog::set_level(spdlog::level::debug);
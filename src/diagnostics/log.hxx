@@ -0,0 +1,106 @@
+#pragma once
+
+#ifndef LINALG_LOG_HXX
+#define LINALG_LOG_HXX
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "spdlog/spdlog.h"
+
+// Lowest level compiled into the library, one of the SPDLOG_LEVEL_* values.
+// Statements below it expand to nothing and their arguments are never
+// evaluated, so debug traces in inner loops cost nothing in release builds.
+#ifndef LINALG_ACTIVE_LOG_LEVEL
+#define LINALG_ACTIVE_LOG_LEVEL SPDLOG_LEVEL_WARN
+#endif
+
+namespace linalg::log {
+
+    inline constexpr const char* LOGGER_NAME = "global_logger";
+
+    namespace detail {
+
+        struct LoggerCache {
+            std::mutex                                          mutex;
+            std::atomic<spdlog::logger*>                        current{nullptr};
+            // Loggers are never released while cached, so a pointer handed
+            // out to another thread stays valid after `set_logger`
+            std::vector<std::shared_ptr<spdlog::logger>>        owned;
+        };
+
+        inline LoggerCache& cache() {
+            static LoggerCache instance;
+            return instance;
+        }
+
+    }
+
+    // Library logger. The spdlog registry (a mutex-guarded map) is consulted
+    // only until "global_logger" is found; afterwards this is a single load.
+    inline spdlog::logger* logger() {
+        auto& c = detail::cache();
+
+        if (spdlog::logger* cached = c.current.load(std::memory_order_acquire)) return cached;
+
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (spdlog::logger* cached = c.current.load(std::memory_order_relaxed)) return cached;
+
+        auto found = spdlog::get(LOGGER_NAME);
+        if (!found) return nullptr;
+
+        c.owned.push_back(found);
+        c.current.store(found.get(), std::memory_order_release);
+        return found.get();
+    }
+
+    // Replaces the cached logger, e.g. after re-registering "global_logger"
+    inline void set_logger(std::shared_ptr<spdlog::logger> _logger) {
+        auto& c = detail::cache();
+
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (_logger) c.owned.push_back(_logger);
+        c.current.store(_logger.get(), std::memory_order_release);
+    }
+
+}
+
+#define LINALG_LOG_CALL(method, ...)                                                    \
+    do {                                                                                \
+        if (spdlog::logger* linalg_logger_ = linalg::log::logger()) {                   \
+            linalg_logger_->method(__VA_ARGS__);                                        \
+        }                                                                               \
+    } while (0)
+
+#if LINALG_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_TRACE
+#define LINALG_LOG_TRACE(...) LINALG_LOG_CALL(trace, __VA_ARGS__)
+#else
+#define LINALG_LOG_TRACE(...) (void)0
+#endif
+
+#if LINALG_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define LINALG_LOG_DEBUG(...) LINALG_LOG_CALL(debug, __VA_ARGS__)
+#else
+#define LINALG_LOG_DEBUG(...) (void)0
+#endif
+
+#if LINALG_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_INFO
+#define LINALG_LOG_INFO(...) LINALG_LOG_CALL(info, __VA_ARGS__)
+#else
+#define LINALG_LOG_INFO(...) (void)0
+#endif
+
+#if LINALG_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_WARN
+#define LINALG_LOG_WARN(...) LINALG_LOG_CALL(warn, __VA_ARGS__)
+#else
+#define LINALG_LOG_WARN(...) (void)0
+#endif
+
+#if LINALG_ACTIVE_LOG_LEVEL <= SPDLOG_LEVEL_ERROR
+#define LINALG_LOG_ERROR(...) LINALG_LOG_CALL(error, __VA_ARGS__)
+#else
+#define LINALG_LOG_ERROR(...) (void)0
+#endif
+
+#endif // LINALG_LOG_HXX
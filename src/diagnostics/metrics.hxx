@@ -0,0 +1,235 @@
+#pragma once
+
+#ifndef LINALG_METRICS_HXX
+#define LINALG_METRICS_HXX
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Instrumentation counters and timers.
+//
+// Every thread owns a block of counters that only it writes (plain relaxed
+// load + store, no locked instructions), so recording an event costs about
+// as much as incrementing a local variable. `snapshot()` walks all blocks and
+// sums them on demand. Blocks of exited threads are folded into a retired
+// total, so nothing recorded is ever lost.
+//
+// Define LINALG_METRICS=0 to compile every recording call out.
+
+#ifndef LINALG_METRICS
+#define LINALG_METRICS 1
+#endif
+
+namespace linalg::metrics {
+
+    enum class Counter : std::size_t {
+        nnz_touched,            // Stored nonzeros read or written by kernels and conversions
+        inserts,                // New nonzeros inserted into a compressed format
+        erases,                 // Nonzeros removed from a compressed format
+        conversions,            // Format conversions (dense -> sparse, COO -> CRS, ...)
+        bytes_allocated,        // Bytes allocated for matrix storage and kernel workspaces
+        flops,                  // Multiply-add pairs counted as 2 flops
+        COUNT
+    };
+
+    enum class Timer : std::size_t {
+        gemm,
+        gemv,
+        spmv,
+        spmm,
+        conversion,
+        solve,
+        COUNT
+    };
+
+    inline constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::COUNT);
+    inline constexpr std::size_t TIMER_COUNT = static_cast<std::size_t>(Timer::COUNT);
+
+    inline const char* name(Counter counter) {
+        static constexpr const char* names[COUNTER_COUNT] = {
+            "nnz_touched", "inserts", "erases", "conversions", "bytes_allocated", "flops"
+        };
+        return names[static_cast<std::size_t>(counter)];
+    }
+
+    inline const char* name(Timer timer) {
+        static constexpr const char* names[TIMER_COUNT] = {
+            "gemm", "gemv", "spmv", "spmm", "conversion", "solve"
+        };
+        return names[static_cast<std::size_t>(timer)];
+    }
+
+    // Aggregated values at one point in time
+    struct Snapshot {
+        std::array<std::uint64_t, COUNTER_COUNT>    counters{};
+        std::array<std::uint64_t, TIMER_COUNT>      timer_calls{};
+        std::array<std::uint64_t, TIMER_COUNT>      timer_nanoseconds{};
+
+        std::uint64_t operator[](Counter counter) const { return counters[static_cast<std::size_t>(counter)]; }
+
+        std::uint64_t calls(Timer timer) const { return timer_calls[static_cast<std::size_t>(timer)]; }
+        double seconds(Timer timer) const { return timer_nanoseconds[static_cast<std::size_t>(timer)] * 1e-9; }
+
+        Snapshot operator-(const Snapshot& _oth) const {
+            Snapshot diff;
+            for (std::size_t k = 0; k < COUNTER_COUNT; ++k) diff.counters[k] = counters[k] - _oth.counters[k];
+            for (std::size_t k = 0; k < TIMER_COUNT; ++k) {
+                diff.timer_calls[k] = timer_calls[k] - _oth.timer_calls[k];
+                diff.timer_nanoseconds[k] = timer_nanoseconds[k] - _oth.timer_nanoseconds[k];
+            }
+            return diff;
+        }
+
+        std::string print() const {
+            std::ostringstream output;
+
+            for (std::size_t k = 0; k < COUNTER_COUNT; ++k) {
+                output << name(static_cast<Counter>(k)) << ": " << counters[k] << "\n";
+            }
+            for (std::size_t k = 0; k < TIMER_COUNT; ++k) {
+                output << name(static_cast<Timer>(k)) << ": " << timer_calls[k] << " calls, "
+                       << timer_nanoseconds[k] * 1e-9 << " s\n";
+            }
+
+            return output.str();
+        }
+    };
+
+    namespace detail {
+
+        // Written only by its owning thread, read by `snapshot()`
+        struct ThreadBlock {
+            std::array<std::atomic<std::uint64_t>, COUNTER_COUNT>      counters{};
+            std::array<std::atomic<std::uint64_t>, TIMER_COUNT>        timer_calls{};
+            std::array<std::atomic<std::uint64_t>, TIMER_COUNT>        timer_nanoseconds{};
+
+            void add_to(Snapshot& total) const {
+                for (std::size_t k = 0; k < COUNTER_COUNT; ++k) {
+                    total.counters[k] += counters[k].load(std::memory_order_relaxed);
+                }
+                for (std::size_t k = 0; k < TIMER_COUNT; ++k) {
+                    total.timer_calls[k] += timer_calls[k].load(std::memory_order_relaxed);
+                    total.timer_nanoseconds[k] += timer_nanoseconds[k].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        struct Registry {
+            std::mutex                      mutex;
+            std::vector<ThreadBlock*>       live;
+            Snapshot                        retired;
+            Snapshot                        baseline;
+        };
+
+        // Leaked on purpose: pool workers may exit after static destructors ran
+        inline Registry& registry() {
+            static Registry* instance = new Registry();
+            return *instance;
+        }
+
+        // Registers on first use, folds into `retired` on thread exit
+        struct ThreadHandle {
+            ThreadBlock block;
+
+            ThreadHandle() {
+                auto& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.live.push_back(&block);
+            }
+
+            ~ThreadHandle() {
+                auto& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                block.add_to(reg.retired);
+                std::erase(reg.live, &block);
+            }
+        };
+
+        inline ThreadBlock& local() {
+            thread_local ThreadHandle handle;
+            return handle.block;
+        }
+
+        inline void bump(std::atomic<std::uint64_t>& slot, std::uint64_t amount) {
+            slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+    }
+
+    inline void add(Counter counter, std::uint64_t amount = 1) {
+#if LINALG_METRICS
+        detail::bump(detail::local().counters[static_cast<std::size_t>(counter)], amount);
+#else
+        (void)counter;
+        (void)amount;
+#endif
+    }
+
+    inline void record(Timer timer, std::uint64_t nanoseconds) {
+#if LINALG_METRICS
+        auto& block = detail::local();
+        detail::bump(block.timer_calls[static_cast<std::size_t>(timer)], 1);
+        detail::bump(block.timer_nanoseconds[static_cast<std::size_t>(timer)], nanoseconds);
+#else
+        (void)timer;
+        (void)nanoseconds;
+#endif
+    }
+
+    // Records the lifetime of the scope under `timer`
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Timer _timer) : timer(_timer) {
+#if LINALG_METRICS
+            start = std::chrono::steady_clock::now();
+#endif
+        }
+
+        ~ScopedTimer() {
+#if LINALG_METRICS
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            record(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#endif
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        Timer                                               timer;
+        std::chrono::steady_clock::time_point               start;
+    };
+
+    // Totals over all threads since start-up or the last `reset()`
+    inline Snapshot snapshot() {
+        auto& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        Snapshot total = reg.retired;
+        for (const detail::ThreadBlock* block : reg.live) block->add_to(total);
+
+        return total - reg.baseline;
+    }
+
+    // Starts counting from zero again. Blocks stay owned by their threads,
+    // so this moves the baseline instead of writing into them.
+    inline void reset() {
+        auto& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        Snapshot total = reg.retired;
+        for (const detail::ThreadBlock* block : reg.live) block->add_to(total);
+
+        reg.baseline = total;
+    }
+
+}
+
+#endif // LINALG_METRICS_HXX
@@ -0,0 +1,310 @@
+#pragma once
+
+#ifndef LINALG_EXPRESSION_HXX
+#define LINALG_EXPRESSION_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include "../../include/linalg/linalg.hxx"
+#include "../diagnostics/log.hxx"
+
+// Lazy elementwise expressions.
+//
+// `A + B * 2.0 - C` builds a tree of small value types (leaves keep pointers
+// into the operand storage, inner nodes keep their children by value) and
+// nothing is computed until the tree is assigned to a Matrix. Assignment then
+// runs a single pass over the destination, see `Matrix<T>::assign_expression`.
+// Store results in a Matrix, not `auto`: nodes refer to their operands.
+//
+// Every node provides three ways to read element (i, j):
+//   at_dense(i, j)   all matrix leaves are dense; pure, so the row loop vectorizes
+//   at(i, j)         leaves may be CRS; call `begin_row(i)` first and walk j upwards
+//   seek(j)          smallest stored column >= j among the CRS leaves of the row
+// The evaluator picks one of them once per assignment from the operand formats.
+
+namespace linalg::expr {
+
+    // `seek` result when no stored column is left in the row
+    inline constexpr long long END = std::numeric_limits<long long>::max();
+
+    template<typename E>
+    concept Node = requires { typename E::value_type; } && E::is_expression_node;
+
+    template<typename S>
+    concept Scalar = std::is_arithmetic_v<S>;
+
+    struct Plus {
+        template<typename T>
+        static T apply(const T& a, const T& b) { return a + b; }
+    };
+
+    struct Minus {
+        template<typename T>
+        static T apply(const T& a, const T& b) { return a - b; }
+    };
+
+    inline void check_dims(std::size_t l_rows, std::size_t l_cols, std::size_t r_rows, std::size_t r_cols) {
+        if (l_rows == r_rows && l_cols == r_cols) return;
+
+        std::ostringstream oss;
+        oss << "Elementwise dimension mismatch: (" << l_rows << ", " << l_cols
+            << ") and (" << r_rows << ", " << r_cols << ").";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
+
+    // Reference to a Matrix operand; reads CRS arrays when the matrix is held
+    // in CRS form and its dense buffer otherwise
+    template<typename T>
+    class MatrixLeaf {
+    public:
+        using value_type = T;
+        static constexpr bool is_expression_node = true;
+        // Zero wherever the operand is zero, so a sum of such nodes stays sparse
+        static constexpr bool sparse_closed = true;
+
+        explicit MatrixLeaf(const linalg::Matrix<T>& _matrix);
+
+        std::size_t rows() const { return n_rows; }
+        std::size_t cols() const { return n_cols; }
+
+        bool any_sparse() const { return sparse; }
+        bool all_sparse() const { return sparse; }
+
+        void begin_row(std::size_t i) {
+            if (!sparse) return;
+            pos = ptr[i];
+            end = ptr[i + 1];
+        }
+
+        T at_dense(std::size_t i, std::size_t j) const { return data[i * ld + j]; }
+
+        T at(std::size_t i, std::size_t j) {
+            if (!sparse) return data[i * ld + j];
+
+            while (pos < end && idx[pos] < static_cast<long long>(j)) ++pos;
+            return pos < end && idx[pos] == static_cast<long long>(j) ? vals[pos] : T(0);
+        }
+
+        long long seek(long long j) {
+            while (pos < end && idx[pos] < j) ++pos;
+            return pos < end ? idx[pos] : END;
+        }
+
+    private:
+        std::size_t                 n_rows = 0;
+        std::size_t                 n_cols = 0;
+        bool                        sparse = false;
+
+        // Dense operand
+        const T*                    data = nullptr;
+        std::size_t                 ld = 0;
+
+        // CRS operand and the cursor into the current row
+        const long long*            ptr = nullptr;
+        const long long*            idx = nullptr;
+        const T*                    vals = nullptr;
+        long long                   pos = 0;
+        long long                   end = 0;
+    };
+
+    // Scalar broadcast to every element, used by `A + s` / `s - A`
+    template<typename T>
+    class ScalarLeaf {
+    public:
+        using value_type = T;
+        static constexpr bool is_expression_node = true;
+        static constexpr bool sparse_closed = false;
+
+        explicit ScalarLeaf(T _value) : value(_value) {}
+
+        bool any_sparse() const { return false; }
+        bool all_sparse() const { return false; }
+
+        void begin_row(std::size_t) {}
+        T at_dense(std::size_t, std::size_t) const { return value; }
+        T at(std::size_t, std::size_t) { return value; }
+        long long seek(long long) { return END; }
+
+    private:
+        T                           value;
+    };
+
+    // Takes its dimensions from whichever side is not a scalar
+    template<typename L, typename R, typename Op>
+    class Binary {
+    public:
+        using value_type = typename L::value_type;
+        static constexpr bool is_expression_node = true;
+        static constexpr bool sparse_closed = L::sparse_closed && R::sparse_closed;
+
+        static_assert(std::is_same_v<typename L::value_type, typename R::value_type>,
+                      "Operands of an elementwise expression must share the element type");
+
+        Binary(const L& _lhs, const R& _rhs) : lhs(_lhs), rhs(_rhs) {
+            if constexpr (!is_scalar<L> && !is_scalar<R>) {
+                check_dims(lhs.rows(), lhs.cols(), rhs.rows(), rhs.cols());
+            }
+        }
+
+        std::size_t rows() const {
+            if constexpr (is_scalar<L>) return rhs.rows();
+            else return lhs.rows();
+        }
+
+        std::size_t cols() const {
+            if constexpr (is_scalar<L>) return rhs.cols();
+            else return lhs.cols();
+        }
+
+        bool any_sparse() const { return lhs.any_sparse() || rhs.any_sparse(); }
+        bool all_sparse() const { return lhs.all_sparse() && rhs.all_sparse(); }
+
+        void begin_row(std::size_t i) {
+            lhs.begin_row(i);
+            rhs.begin_row(i);
+        }
+
+        value_type at_dense(std::size_t i, std::size_t j) const {
+            return Op::apply(lhs.at_dense(i, j), rhs.at_dense(i, j));
+        }
+
+        value_type at(std::size_t i, std::size_t j) {
+            return Op::apply(lhs.at(i, j), rhs.at(i, j));
+        }
+
+        long long seek(long long j) {
+            long long l = lhs.seek(j);
+            long long r = rhs.seek(j);
+            return std::min(l, r);
+        }
+
+    private:
+        template<typename X>
+        static constexpr bool is_scalar = std::is_same_v<X, ScalarLeaf<typename X::value_type>>;
+
+        L                           lhs;
+        R                           rhs;
+    };
+
+    // Child multiplied by a scalar factor (also unary minus, with -1)
+    template<typename E>
+    class Scaled {
+    public:
+        using value_type = typename E::value_type;
+        static constexpr bool is_expression_node = true;
+        static constexpr bool sparse_closed = E::sparse_closed;
+
+        Scaled(const E& _child, value_type _factor) : child(_child), factor(_factor) {}
+
+        std::size_t rows() const { return child.rows(); }
+        std::size_t cols() const { return child.cols(); }
+
+        bool any_sparse() const { return child.any_sparse(); }
+        bool all_sparse() const { return child.all_sparse(); }
+
+        void begin_row(std::size_t i) { child.begin_row(i); }
+
+        value_type at_dense(std::size_t i, std::size_t j) const { return factor * child.at_dense(i, j); }
+        value_type at(std::size_t i, std::size_t j) { return factor * child.at(i, j); }
+        long long seek(long long j) { return child.seek(j); }
+
+    private:
+        E                           child;
+        value_type                  factor;
+    };
+
+    // Maps what may appear in an expression (a Matrix or a node) to its node type
+    template<typename X>
+    struct operand;
+
+    template<typename T>
+    struct operand<linalg::Matrix<T>> {
+        using type = MatrixLeaf<T>;
+        static type make(const linalg::Matrix<T>& _matrix) { return type(_matrix); }
+    };
+
+    template<Node E>
+    struct operand<E> {
+        using type = E;
+        static const E& make(const E& _expr) { return _expr; }
+    };
+
+    template<typename X>
+    concept Operand = requires { typename operand<X>::type; };
+
+    template<Operand X>
+    using node_t = typename operand<X>::type;
+
+    template<Operand L, Operand R>
+    auto operator+(const L& lhs, const R& rhs) {
+        return Binary<node_t<L>, node_t<R>, Plus>(operand<L>::make(lhs), operand<R>::make(rhs));
+    }
+
+    template<Operand L, Operand R>
+    auto operator-(const L& lhs, const R& rhs) {
+        return Binary<node_t<L>, node_t<R>, Minus>(operand<L>::make(lhs), operand<R>::make(rhs));
+    }
+
+    template<Operand E, Scalar S>
+    auto operator*(const E& _expr, S scalar) {
+        using T = typename node_t<E>::value_type;
+        return Scaled<node_t<E>>(operand<E>::make(_expr), static_cast<T>(scalar));
+    }
+
+    template<Scalar S, Operand E>
+    auto operator*(S scalar, const E& _expr) {
+        return _expr * scalar;
+    }
+
+    template<Operand E, Scalar S>
+    auto operator+(const E& _expr, S scalar) {
+        using T = typename node_t<E>::value_type;
+        return Binary<node_t<E>, ScalarLeaf<T>, Plus>(operand<E>::make(_expr), ScalarLeaf<T>(static_cast<T>(scalar)));
+    }
+
+    template<Scalar S, Operand E>
+    auto operator+(S scalar, const E& _expr) {
+        return _expr + scalar;
+    }
+
+    template<Operand E, Scalar S>
+    auto operator-(const E& _expr, S scalar) {
+        using T = typename node_t<E>::value_type;
+        return Binary<node_t<E>, ScalarLeaf<T>, Minus>(operand<E>::make(_expr), ScalarLeaf<T>(static_cast<T>(scalar)));
+    }
+
+    template<Scalar S, Operand E>
+    auto operator-(S scalar, const E& _expr) {
+        using T = typename node_t<E>::value_type;
+        return Binary<ScalarLeaf<T>, node_t<E>, Minus>(ScalarLeaf<T>(static_cast<T>(scalar)), operand<E>::make(_expr));
+    }
+
+    template<Operand E>
+    auto operator-(const E& _expr) {
+        using T = typename node_t<E>::value_type;
+        return Scaled<node_t<E>>(operand<E>::make(_expr), static_cast<T>(-1));
+    }
+
+    template<Operand E>
+    auto operator+(const E& _expr) {
+        return node_t<E>(operand<E>::make(_expr));
+    }
+
+}
+
+namespace linalg {
+
+    // Found by argument-dependent lookup on Matrix operands
+    using linalg::expr::operator+;
+    using linalg::expr::operator-;
+    using linalg::expr::operator*;
+
+}
+
+#endif // LINALG_EXPRESSION_HXX
@@ -0,0 +1,267 @@
+#pragma once
+
+#ifndef LINALG_BINARY_FORMAT_HXX
+#define LINALG_BINARY_FORMAT_HXX
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "../matrix/aligned_allocator.hxx"
+#include "../diagnostics/log.hxx"
+#include "../parallel/thread_pool.hxx"
+#include "mapped_file.hxx"
+
+// Native on-disk layout of a compressed sparse matrix.
+//
+//   offset 0     BinaryHeader (128 bytes)
+//   pointers     (outer + 1) x index, 64-byte aligned
+//   indexes      nnz x index, 64-byte aligned
+//   values       nnz x value, 64-byte aligned
+//
+// "outer" is the row count for CRS and the column count for CCS. Arrays are
+// stored in native byte order exactly as they sit in memory, so a mapped file
+// is used in place. Files of another byte order, element type or index width
+// are rejected when opened rather than converted.
+
+namespace linalg::io {
+
+    inline constexpr char BINARY_MAGIC[8] = {'L', 'N', 'A', 'L', 'G', 'S', 'P', 'M'};
+    inline constexpr std::uint32_t BINARY_VERSION = 1;
+    // Reads back as 0x04030201 on a machine of the other endianness
+    inline constexpr std::uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+    enum class BinaryLayout : std::uint32_t {
+        CRS = 0,
+        CCS = 1
+    };
+
+    enum class ValueKind : std::uint32_t {
+        floating = 0,
+        signed_integer = 1,
+        unsigned_integer = 2
+    };
+
+    struct BinaryHeader {
+        char                    magic[8];
+        std::uint32_t           version;
+        std::uint32_t           byte_order;
+        std::uint32_t           layout;
+        std::uint32_t           value_kind;
+        std::uint32_t           value_bytes;
+        std::uint32_t           index_bytes;
+        std::uint64_t           rows;
+        std::uint64_t           cols;
+        std::uint64_t           nnz;
+        std::uint64_t           pointers_offset;
+        std::uint64_t           indexes_offset;
+        std::uint64_t           values_offset;
+        std::uint8_t            reserved[48];
+    };
+
+    static_assert(sizeof(BinaryHeader) == 128, "BinaryHeader must stay 128 bytes");
+    static_assert(std::is_trivially_copyable_v<BinaryHeader>);
+
+    template<typename T>
+    constexpr ValueKind value_kind() {
+        if constexpr (std::is_floating_point_v<T>) return ValueKind::floating;
+        else if constexpr (std::is_signed_v<T>) return ValueKind::signed_integer;
+        else return ValueKind::unsigned_integer;
+    }
+
+    constexpr std::uint64_t align_offset(std::uint64_t offset) {
+        constexpr std::uint64_t step = linalg::detail::DENSE_ALIGNMENT;
+        return (offset + step - 1) / step * step;
+    }
+
+    // Header of a file with the given shape; arrays follow at aligned offsets
+    template<typename T, typename I>
+    BinaryHeader make_header(BinaryLayout layout, std::uint64_t rows, std::uint64_t cols, std::uint64_t nnz) {
+        BinaryHeader header{};
+        std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        header.version = BINARY_VERSION;
+        header.byte_order = BINARY_BYTE_ORDER;
+        header.layout = static_cast<std::uint32_t>(layout);
+        header.value_kind = static_cast<std::uint32_t>(value_kind<T>());
+        header.value_bytes = sizeof(T);
+        header.index_bytes = sizeof(I);
+        header.rows = rows;
+        header.cols = cols;
+        header.nnz = nnz;
+
+        std::uint64_t n_outer = layout == BinaryLayout::CRS ? rows : cols;
+
+        header.pointers_offset = align_offset(sizeof(BinaryHeader));
+        header.indexes_offset = align_offset(header.pointers_offset + (n_outer + 1) * sizeof(I));
+        header.values_offset = align_offset(header.indexes_offset + nnz * sizeof(I));
+
+        return header;
+    }
+
+    template<typename T, typename I>
+    void write_binary(const std::string& path, BinaryLayout layout, std::uint64_t rows, std::uint64_t cols,
+                      const I* pointers, const I* indexes, const T* values) {
+        std::uint64_t n_outer = layout == BinaryLayout::CRS ? rows : cols;
+        std::uint64_t nnz = pointers ? static_cast<std::uint64_t>(pointers[n_outer]) : 0;
+        BinaryHeader header = make_header<T, I>(layout, rows, cols, nnz);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            LINALG_LOG_ERROR("Cannot open `{}` for writing", path);
+            throw std::runtime_error("Cannot open `" + path + "` for writing.");
+        }
+
+        static constexpr char zeros[linalg::detail::DENSE_ALIGNMENT] = {};
+
+        auto pad_to = [&](std::uint64_t offset) {
+            std::uint64_t at = static_cast<std::uint64_t>(file.tellp());
+            file.write(zeros, static_cast<std::streamsize>(offset - at));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        pad_to(header.pointers_offset);
+        if (pointers) {
+            file.write(reinterpret_cast<const char*>(pointers), static_cast<std::streamsize>((n_outer + 1) * sizeof(I)));
+        }
+        else {
+            // Empty matrix: still a valid all-zero pointer array
+            for (std::uint64_t k = 0; k <= n_outer; ++k) {
+                I zero = 0;
+                file.write(reinterpret_cast<const char*>(&zero), sizeof(I));
+            }
+        }
+
+        pad_to(header.indexes_offset);
+        file.write(reinterpret_cast<const char*>(indexes), static_cast<std::streamsize>(nnz * sizeof(I)));
+
+        pad_to(header.values_offset);
+        file.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(nnz * sizeof(T)));
+
+        if (!file.flush()) {
+            LINALG_LOG_ERROR("Writing `{}` failed", path);
+            throw std::runtime_error("Writing `" + path + "` failed.");
+        }
+
+        LINALG_LOG_INFO("Wrote binary sparse matrix `{}`: ({}, {}), {} nonzeros", path, rows, cols, nnz);
+    }
+
+    // Arrays of a mapped file; `file` owns the memory they point into
+    template<typename T, typename I>
+    struct BinaryView {
+        BinaryHeader                            header;
+        std::shared_ptr<MappedFile>             file;
+        const I*                                pointers = nullptr;
+        const I*                                indexes = nullptr;
+        const T*                                values = nullptr;
+        std::uint64_t                           n_outer = 0;
+    };
+
+    namespace detail {
+
+        inline constexpr std::size_t VALIDATE_CHUNK = 1 << 16;
+
+        // True when the pointers never decrease and every index lies in [0, n_inner)
+        template<typename I>
+        bool valid_structure(const I* pointers, const I* indexes, std::uint64_t n_outer, std::uint64_t nnz,
+                             std::uint64_t n_inner) {
+            for (std::uint64_t k = 0; k < n_outer; ++k) {
+                if (pointers[k + 1] < pointers[k]) return false;
+            }
+
+            std::atomic<bool> valid{true};
+            std::size_t chunks = static_cast<std::size_t>((nnz + VALIDATE_CHUNK - 1) / VALIDATE_CHUNK);
+
+            linalg::parallel::parallel_for(chunks, [&](std::size_t chunk, std::size_t) {
+                std::uint64_t begin = chunk * VALIDATE_CHUNK;
+                std::uint64_t end = std::min<std::uint64_t>(nnz, begin + VALIDATE_CHUNK);
+
+                for (std::uint64_t k = begin; k < end; ++k) {
+                    if (indexes[k] < 0 || static_cast<std::uint64_t>(indexes[k]) >= n_inner) {
+                        valid.store(false, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            });
+
+            return valid.load();
+        }
+
+    }
+
+    // Maps `path` and checks the header against `T` / `I`. With `validate`
+    // the whole structure is checked as well (monotonic pointers, indexes in
+    // range), which costs one pass over the pointers and indexes; without it
+    // only the ends of the pointer array are, and the file must be trusted.
+    template<typename T, typename I>
+    BinaryView<T, I> map_binary(const std::string& path, bool validate = true) {
+        BinaryView<T, I> view;
+        view.file = std::make_shared<MappedFile>(path);
+
+        auto reject = [&](const std::string& reason) {
+            std::string message = "Cannot open `" + path + "` as a binary sparse matrix: " + reason + ".";
+
+            LINALG_LOG_ERROR(message);
+            throw std::runtime_error(message);
+        };
+
+        std::size_t size = view.file->size();
+        if (size < sizeof(BinaryHeader)) reject("file is shorter than the header");
+
+        std::memcpy(&view.header, view.file->data(), sizeof(BinaryHeader));
+        const BinaryHeader& header = view.header;
+
+        if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) reject("bad magic");
+        if (header.byte_order != BINARY_BYTE_ORDER) reject("byte order differs from this machine");
+        if (header.version != BINARY_VERSION) reject("unsupported version " + std::to_string(header.version));
+        if (header.layout > static_cast<std::uint32_t>(BinaryLayout::CCS)) reject("unknown layout");
+        if (header.value_kind != static_cast<std::uint32_t>(value_kind<T>()) || header.value_bytes != sizeof(T)) {
+            reject("stored element type differs from the requested one");
+        }
+        if (header.index_bytes != sizeof(I)) reject("stored index width differs from the requested one");
+
+        view.n_outer = header.layout == static_cast<std::uint32_t>(BinaryLayout::CRS) ? header.rows : header.cols;
+        std::uint64_t n_inner = header.layout == static_cast<std::uint32_t>(BinaryLayout::CRS) ? header.cols : header.rows;
+
+        // Every array has to fit in the file, which also keeps the offset
+        // arithmetic below from overflowing
+        if (view.n_outer >= size / sizeof(I) || header.nnz > size / sizeof(I) || header.nnz > size / sizeof(T)) {
+            reject("array sizes exceed the file size");
+        }
+
+        BinaryHeader expected = make_header<T, I>(static_cast<BinaryLayout>(header.layout),
+                                                  header.rows, header.cols, header.nnz);
+        if (header.pointers_offset != expected.pointers_offset ||
+            header.indexes_offset != expected.indexes_offset ||
+            header.values_offset != expected.values_offset) {
+            reject("array offsets do not match the layout");
+        }
+        if (header.values_offset + header.nnz * sizeof(T) > size) reject("file is truncated");
+
+        const std::byte* base = view.file->data();
+        view.pointers = reinterpret_cast<const I*>(base + header.pointers_offset);
+        view.indexes = reinterpret_cast<const I*>(base + header.indexes_offset);
+        view.values = reinterpret_cast<const T*>(base + header.values_offset);
+
+        if (view.pointers[0] != 0 || static_cast<std::uint64_t>(view.pointers[view.n_outer]) != header.nnz) {
+            reject("pointer array does not span the stored entries");
+        }
+        if (validate && !detail::valid_structure(view.pointers, view.indexes, view.n_outer, header.nnz, n_inner)) {
+            reject("pointers decrease or an index is out of range");
+        }
+
+        LINALG_LOG_INFO("Mapped binary sparse matrix `{}`: ({}, {}), {} nonzeros",
+                        path, header.rows, header.cols, header.nnz);
+
+        return view;
+    }
+
+}
+
+#endif // LINALG_BINARY_FORMAT_HXX
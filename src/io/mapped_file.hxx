@@ -0,0 +1,78 @@
+#pragma once
+
+#ifndef LINALG_MAPPED_FILE_HXX
+#define LINALG_MAPPED_FILE_HXX
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../diagnostics/log.hxx"
+
+namespace linalg::io {
+
+    // Whole file mapped into memory for the lifetime of the object.
+    //
+    // The file is opened and mapped read-only: pages are shared with the page
+    // cache and any write through the mapping faults. Users that need to
+    // modify the data copy it out first (see SparseArray).
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) fail("open", path);
+
+            struct stat info {};
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                fail("stat", path);
+            }
+
+            length = static_cast<std::size_t>(info.st_size);
+
+            if (length > 0) {
+                void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address == MAP_FAILED) {
+                    ::close(fd);
+                    fail("mmap", path);
+                }
+                bytes = static_cast<std::byte*>(address);
+            }
+
+            // The mapping stays valid after the descriptor is closed
+            ::close(fd);
+
+            LINALG_LOG_DEBUG("Mapped `{}` ({} bytes)", path, length);
+        }
+
+        ~MappedFile() {
+            if (bytes) ::munmap(bytes, length);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const std::byte* data() const { return bytes; }
+        std::size_t size() const { return length; }
+
+    private:
+        [[noreturn]] static void fail(const char* call, const std::string& path) {
+            std::string message = std::string("Cannot map `") + path + "`: " + call + " failed (" +
+                                  std::strerror(errno) + ").";
+
+            LINALG_LOG_ERROR(message);
+            throw std::runtime_error(message);
+        }
+
+        std::byte*                              bytes = nullptr;
+        std::size_t                             length = 0;
+    };
+
+}
+
+#endif // LINALG_MAPPED_FILE_HXX
@@ -0,0 +1,333 @@
+#pragma once
+
+#ifndef LINALG_MATRIX_MARKET_HXX
+#define LINALG_MATRIX_MARKET_HXX
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../parallel/thread_pool.hxx"
+#include "../diagnostics/log.hxx"
+#include "../diagnostics/metrics.hxx"
+
+// Streaming reader for Matrix Market coordinate files.
+//
+// The file is read in chunks of MATRIX_MARKET_CHUNK bytes. Each chunk is cut
+// at line boundaries into slices that are parsed on the thread pool, and the
+// entries are appended to a triplet builder in file order. Memory in use is
+// the triplets plus one chunk; the dense matrix is never formed.
+
+namespace linalg::io {
+
+    // Bytes read from the file per step
+    inline constexpr std::size_t MATRIX_MARKET_CHUNK = 1 << 24;
+    // Bytes of a chunk parsed by one task
+    inline constexpr std::size_t MATRIX_MARKET_SLICE = 1 << 18;
+
+    struct MatrixMarketHeader {
+        enum class Symmetry { general, symmetric, skew_symmetric };
+
+        bool                                    pattern = false;
+        bool                                    integer = false;
+        Symmetry                                symmetry = Symmetry::general;
+        long long                               rows = 0;
+        long long                               cols = 0;
+        long long                               entries = 0;
+    };
+
+    namespace mm_detail {
+
+        [[noreturn]] inline void fail(const std::string& path, const std::string& reason) {
+            std::string message = "Cannot read Matrix Market file `" + path + "`: " + reason + ".";
+
+            LINALG_LOG_ERROR(message);
+            throw std::runtime_error(message);
+        }
+
+        inline std::string lowercase(std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return text;
+        }
+
+        // Banner, comments and size line; leaves `file` at the first entry
+        inline MatrixMarketHeader read_header(std::istream& file, const std::string& path) {
+            MatrixMarketHeader header;
+            std::string line;
+
+            if (!std::getline(file, line)) fail(path, "file is empty");
+
+            std::istringstream banner(line);
+            std::string tag, object, format, field, symmetry;
+            banner >> tag >> object >> format >> field >> symmetry;
+
+            if (tag != "%%MatrixMarket") fail(path, "missing %%MatrixMarket banner");
+            if (lowercase(object) != "matrix") fail(path, "object `" + object + "` is not a matrix");
+            if (lowercase(format) != "coordinate") fail(path, "only the coordinate format is supported");
+
+            field = lowercase(field);
+            if (field == "pattern") header.pattern = true;
+            else if (field == "integer") header.integer = true;
+            else if (field != "real" && field != "double") fail(path, "unsupported field `" + field + "`");
+
+            symmetry = lowercase(symmetry);
+            if (symmetry == "symmetric") header.symmetry = MatrixMarketHeader::Symmetry::symmetric;
+            else if (symmetry == "skew-symmetric") header.symmetry = MatrixMarketHeader::Symmetry::skew_symmetric;
+            else if (symmetry != "general") fail(path, "unsupported symmetry `" + symmetry + "`");
+
+            while (std::getline(file, line)) {
+                std::size_t first = line.find_first_not_of(" \t\r");
+                if (first == std::string::npos || line[first] == '%') continue;
+
+                std::istringstream size_line(line);
+                if (!(size_line >> header.rows >> header.cols >> header.entries) ||
+                    header.rows < 0 || header.cols < 0 || header.entries < 0) {
+                    fail(path, "malformed size line `" + line + "`");
+                }
+                return header;
+            }
+
+            fail(path, "missing size line");
+        }
+
+        // Bytes from the current position to the end of `file`, or -1 when
+        // the stream cannot seek (a pipe)
+        inline long long bytes_left(std::istream& file) {
+            std::streampos position = file.tellg();
+            if (position < 0 || !file.seekg(0, std::ios::end)) {
+                file.clear();
+                return -1;
+            }
+
+            long long left = static_cast<long long>(file.tellg() - position);
+            file.seekg(position);
+            return left;
+        }
+
+        inline const char* skip_blanks(const char* p, const char* end) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+            return p;
+        }
+
+        template<typename V>
+        bool parse_number(const char*& p, const char* end, V& out) {
+            p = skip_blanks(p, end);
+            if (p < end && *p == '+') ++p;
+
+            auto [next, error] = std::from_chars(p, end, out);
+            if (error != std::errc()) return false;
+
+            p = next;
+            return true;
+        }
+
+        template<typename T>
+        bool parse_value(const char*& p, const char* end, bool integer_field, T& out) {
+            if constexpr (std::is_floating_point_v<T>) {
+                return parse_number(p, end, out);
+            }
+            else if (integer_field) {
+                long long value = 0;
+                if (!parse_number(p, end, value)) return false;
+                out = static_cast<T>(value);
+                return true;
+            }
+            else {
+                double value = 0;
+                if (!parse_number(p, end, value)) return false;
+                out = static_cast<T>(value);
+                return true;
+            }
+        }
+
+        // Entries parsed from one slice of a chunk (0-based, mirrored entries included)
+        template<typename T>
+        struct Slice {
+            std::vector<long long>              rows;
+            std::vector<long long>              cols;
+            std::vector<T>                      values;
+            long long                           lines = 0;
+            std::string                         error;
+        };
+
+        template<typename T>
+        void parse_slice(const char* p, const char* end, const MatrixMarketHeader& header, Slice<T>& out) {
+            using Symmetry = MatrixMarketHeader::Symmetry;
+
+            while (p < end) {
+                const char* line_end = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                if (!line_end) line_end = end;
+
+                const char* q = skip_blanks(p, line_end);
+                if (q == line_end || *q == '%') {
+                    p = line_end + 1;
+                    continue;
+                }
+
+                long long i = 0, j = 0;
+                T value = static_cast<T>(1);
+
+                if (!parse_number(q, line_end, i) || !parse_number(q, line_end, j) ||
+                    (!header.pattern && !parse_value(q, line_end, header.integer, value))) {
+                    out.error = "malformed entry `" + std::string(p, line_end) + "`";
+                    return;
+                }
+
+                if (i < 1 || i > header.rows || j < 1 || j > header.cols) {
+                    out.error = "entry (" + std::to_string(i) + ", " + std::to_string(j) + ") outside of (" +
+                                std::to_string(header.rows) + ", " + std::to_string(header.cols) + ")";
+                    return;
+                }
+
+                out.rows.push_back(i - 1);
+                out.cols.push_back(j - 1);
+                out.values.push_back(value);
+                ++out.lines;
+
+                // Only one triangle is stored for symmetric matrices
+                if (header.symmetry != Symmetry::general && i != j) {
+                    out.rows.push_back(j - 1);
+                    out.cols.push_back(i - 1);
+                    out.values.push_back(header.symmetry == Symmetry::symmetric ? value : static_cast<T>(-value));
+                }
+
+                p = line_end + 1;
+            }
+        }
+
+    }
+
+    // Reads the coordinate file `path` into `out`, a triplet builder with
+    // `row_indexes` / `col_indexes` / `values` and `n_rows` / `n_cols` (Matrix<T>::COO).
+    // Symmetric and skew-symmetric files are expanded to both triangles.
+    template<typename T, typename Triplets>
+    MatrixMarketHeader read_matrix_market(const std::string& path, Triplets& out) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) mm_detail::fail(path, "cannot open file");
+
+        MatrixMarketHeader header = mm_detail::read_header(file, path);
+
+        // The shortest entry line is "1 1\n" (pattern) or "1 1 1\n", the last
+        // one may lack its newline. A larger count is rejected before it is
+        // used to reserve the triplets.
+        long long left = mm_detail::bytes_left(file);
+        long long shortest = header.pattern ? 4 : 6;
+        if (left >= 0 && header.entries > (left + 1) / shortest) {
+            mm_detail::fail(path, "size line declares " + std::to_string(header.entries) +
+                                  " entries, more than the remaining " + std::to_string(left) + " bytes can hold");
+        }
+
+        bool mirrored = header.symmetry != MatrixMarketHeader::Symmetry::general;
+        std::size_t capacity = left >= 0 ? static_cast<std::size_t>(header.entries) * (mirrored ? 2 : 1) : 0;
+
+        out.row_indexes.clear();
+        out.col_indexes.clear();
+        out.values.clear();
+        out.row_indexes.reserve(capacity);
+        out.col_indexes.reserve(capacity);
+        out.values.reserve(capacity);
+        out.n_rows = header.rows;
+        out.n_cols = header.cols;
+
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                             capacity * (sizeof(T) + 2 * sizeof(long long)));
+
+        std::vector<char> buffer;
+        std::size_t carried = 0; // Bytes of an unfinished line kept from the previous chunk
+        long long lines = 0;
+
+        for (bool done = false; !done;) {
+            buffer.resize(carried + MATRIX_MARKET_CHUNK);
+            file.read(buffer.data() + carried, MATRIX_MARKET_CHUNK);
+
+            std::size_t filled = carried + static_cast<std::size_t>(file.gcount());
+            done = file.eof() || file.gcount() == 0;
+
+            // Parse up to the last complete line, the rest waits for the next chunk
+            std::size_t complete = filled;
+            if (!done) {
+                const char* last = nullptr;
+                for (std::size_t k = filled; k > 0; --k) {
+                    if (buffer[k - 1] == '\n') {
+                        last = buffer.data() + k;
+                        break;
+                    }
+                }
+
+                if (!last) {
+                    carried = filled; // A line longer than a chunk, keep reading
+                    continue;
+                }
+                complete = last - buffer.data();
+            }
+
+            // Slice boundaries moved forward to the next line start
+            std::vector<const char*> bounds{buffer.data()};
+            const char* chunk_end = buffer.data() + complete;
+
+            while (bounds.back() < chunk_end) {
+                const char* cut = bounds.back() + std::min<std::size_t>(MATRIX_MARKET_SLICE, chunk_end - bounds.back());
+                if (cut < chunk_end) {
+                    const char* newline = static_cast<const char*>(std::memchr(cut, '\n', chunk_end - cut));
+                    cut = newline ? newline + 1 : chunk_end;
+                }
+                bounds.push_back(cut);
+            }
+
+            std::size_t n_slices = bounds.size() - 1;
+            std::vector<mm_detail::Slice<T>> slices(n_slices);
+
+            linalg::parallel::parallel_for(n_slices, [&](std::size_t s, std::size_t) {
+                mm_detail::parse_slice(bounds[s], bounds[s + 1], header, slices[s]);
+            });
+
+            std::vector<std::size_t> offsets(n_slices + 1, out.values.size());
+            for (std::size_t s = 0; s < n_slices; ++s) {
+                if (!slices[s].error.empty()) mm_detail::fail(path, slices[s].error);
+
+                offsets[s + 1] = offsets[s] + slices[s].values.size();
+                lines += slices[s].lines;
+            }
+
+            if (lines > header.entries) {
+                mm_detail::fail(path, "more entries than the " + std::to_string(header.entries) + " declared");
+            }
+
+            out.row_indexes.resize(offsets[n_slices]);
+            out.col_indexes.resize(offsets[n_slices]);
+            out.values.resize(offsets[n_slices]);
+
+            linalg::parallel::parallel_for(n_slices, [&](std::size_t s, std::size_t) {
+                std::copy(slices[s].rows.begin(), slices[s].rows.end(), out.row_indexes.begin() + offsets[s]);
+                std::copy(slices[s].cols.begin(), slices[s].cols.end(), out.col_indexes.begin() + offsets[s]);
+                std::copy(slices[s].values.begin(), slices[s].values.end(), out.values.begin() + offsets[s]);
+            });
+
+            carried = filled - complete;
+            std::memmove(buffer.data(), buffer.data() + complete, carried);
+        }
+
+        if (lines != header.entries) {
+            mm_detail::fail(path, "found " + std::to_string(lines) + " entries, " +
+                                  std::to_string(header.entries) + " declared");
+        }
+
+        linalg::metrics::add(linalg::metrics::Counter::inserts, out.values.size());
+
+        LINALG_LOG_INFO("Read Matrix Market file `{}`: ({}, {}), {} entries",
+                        path, header.rows, header.cols, out.values.size());
+
+        return header;
+    }
+
+}
+
+#endif // LINALG_MATRIX_MARKET_HXX
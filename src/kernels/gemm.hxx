@@ -0,0 +1,286 @@
+#pragma once
+
+#ifndef GEMM_KERNELS_HXX
+#define GEMM_KERNELS_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "../matrix/aligned_allocator.hxx"
+#include "../parallel/thread_pool.hxx"
+#include "../diagnostics/metrics.hxx"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LINALG_X86_KERNELS 1
+#else
+#define LINALG_X86_KERNELS 0
+#endif
+
+// Dense general matrix multiply (GEMM), row-major.
+//
+// Layout follows the usual Goto/BLIS scheme: the output is cut into MC x NC
+// tiles which are distributed over the thread pool. For each tile a KC x NC
+// slice of B and an MC x KC slice of A are packed into contiguous panels
+// (NR columns / MR rows wide) and an MR x NR register-blocked micro-kernel
+// sweeps over them. The micro-kernel is picked once at runtime from the
+// instruction sets the CPU reports (AVX-512F, AVX2+FMA, or portable C++).
+
+namespace linalg::kernels {
+
+    enum class Isa { generic, avx2, avx512 };
+
+    inline Isa detected_isa() {
+#if LINALG_X86_KERNELS
+        static const Isa isa = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return Isa::avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::avx2;
+            return Isa::generic;
+        }();
+        return isa;
+#else
+        return Isa::generic;
+#endif
+    }
+
+    namespace gemm_detail {
+
+        // Cache blocking, in elements
+        inline constexpr std::size_t MC = 96;
+        inline constexpr std::size_t KC = 256;
+        inline constexpr std::size_t NC = 512;
+
+        // `c` (MR x NR, row stride `ldc`) += packed A panel * packed B panel
+        template<typename T>
+        using MicroKernel = void (*)(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc);
+
+        template<typename T>
+        using PackBuffer = std::vector<T, linalg::detail::AlignedAllocator<T>>;
+
+        // Portable MR x NR kernel, also the only path for `long double`
+        template<typename T, std::size_t MR, std::size_t NR>
+        void kernel_generic(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc) {
+            T acc[MR][NR] = {};
+
+            for (std::size_t p = 0; p < kc; ++p) {
+                for (std::size_t r = 0; r < MR; ++r) {
+                    for (std::size_t s = 0; s < NR; ++s) {
+                        acc[r][s] += a[r] * b[s];
+                    }
+                }
+                a += MR;
+                b += NR;
+            }
+
+            for (std::size_t r = 0; r < MR; ++r) {
+                for (std::size_t s = 0; s < NR; ++s) {
+                    c[r * ldc + s] += acc[r][s];
+                }
+            }
+        }
+
+#if LINALG_X86_KERNELS
+        // 6 x (2 * W) kernels written with GCC/Clang vector extensions; the
+        // `target` attribute makes the compiler emit AVX2/AVX-512 code for them
+        // regardless of the flags the rest of the library is built with.
+#define LINALG_GEMM_SIMD_KERNEL(NAME, TARGET)                                                   \
+        template<typename T, std::size_t W>                                                     \
+        __attribute__((target(TARGET)))                                                         \
+        void NAME(std::size_t kc, const T* a, const T* b, T* c, std::size_t ldc) {              \
+            typedef T V __attribute__((vector_size(W * sizeof(T))));                            \
+            V acc[6][2] = {};                                                                   \
+                                                                                                \
+            for (std::size_t p = 0; p < kc; ++p) {                                              \
+                V b0, b1;                                                                       \
+                __builtin_memcpy(&b0, b, sizeof(V));                                            \
+                __builtin_memcpy(&b1, b + W, sizeof(V));                                        \
+                                                                                                \
+                _Pragma("GCC unroll 6")                                                         \
+                for (std::size_t r = 0; r < 6; ++r) {                                           \
+                    V ar = V{} + a[r];                                                          \
+                    acc[r][0] += ar * b0;                                                       \
+                    acc[r][1] += ar * b1;                                                       \
+                }                                                                               \
+                a += 6;                                                                         \
+                b += 2 * W;                                                                     \
+            }                                                                                   \
+                                                                                                \
+            _Pragma("GCC unroll 6")                                                             \
+            for (std::size_t r = 0; r < 6; ++r) {                                               \
+                T* row = c + r * ldc;                                                           \
+                V c0, c1;                                                                       \
+                __builtin_memcpy(&c0, row, sizeof(V));                                          \
+                __builtin_memcpy(&c1, row + W, sizeof(V));                                      \
+                c0 += acc[r][0];                                                                \
+                c1 += acc[r][1];                                                                \
+                __builtin_memcpy(row, &c0, sizeof(V));                                          \
+                __builtin_memcpy(row + W, &c1, sizeof(V));                                      \
+            }                                                                                   \
+        }
+
+        LINALG_GEMM_SIMD_KERNEL(kernel_avx2, "avx2,fma")
+        LINALG_GEMM_SIMD_KERNEL(kernel_avx512, "avx512f,fma")
+
+#undef LINALG_GEMM_SIMD_KERNEL
+#endif
+
+        // Packs rows [0, mc) x cols [0, kc) of A into MR-row panels, zero padded
+        template<typename T, std::size_t MR>
+        void pack_a(std::size_t mc, std::size_t kc, const T* a, std::size_t lda, T* dst) {
+            for (std::size_t i = 0; i < mc; i += MR) {
+                std::size_t rows = std::min(MR, mc - i);
+
+                for (std::size_t p = 0; p < kc; ++p) {
+                    for (std::size_t r = 0; r < MR; ++r) {
+                        *dst++ = r < rows ? a[(i + r) * lda + p] : T(0);
+                    }
+                }
+            }
+        }
+
+        // Packs rows [0, kc) x cols [0, nc) of B into NR-column panels, zero padded
+        template<typename T, std::size_t NR>
+        void pack_b(std::size_t kc, std::size_t nc, const T* b, std::size_t ldb, T* dst) {
+            for (std::size_t j = 0; j < nc; j += NR) {
+                std::size_t cols = std::min(NR, nc - j);
+
+                for (std::size_t p = 0; p < kc; ++p) {
+                    const T* src = b + p * ldb + j;
+
+                    for (std::size_t s = 0; s < cols; ++s) *dst++ = src[s];
+                    for (std::size_t s = cols; s < NR; ++s) *dst++ = T(0);
+                }
+            }
+        }
+
+        template<typename T, std::size_t MR, std::size_t NR>
+        void gemm_blocked(std::size_t M, std::size_t N, std::size_t K,
+                          const T* A, std::size_t lda,
+                          const T* B, std::size_t ldb,
+                          T* C, std::size_t ldc,
+                          MicroKernel<T> kernel) {
+            // Round tile sizes to whole micro-panels
+            constexpr std::size_t mc_max = (MC + MR - 1) / MR * MR;
+            constexpr std::size_t nc_max = (NC + NR - 1) / NR * NR;
+
+            std::size_t tiles_m = (M + mc_max - 1) / mc_max;
+            std::size_t tiles_n = (N + nc_max - 1) / nc_max;
+
+            linalg::parallel::parallel_for(tiles_m * tiles_n, [&](std::size_t task, std::size_t) {
+                thread_local PackBuffer<T> a_pack;
+                thread_local PackBuffer<T> b_pack;
+
+                if (a_pack.size() < mc_max * KC || b_pack.size() < nc_max * KC) {
+                    a_pack.resize(std::max(a_pack.size(), mc_max * KC));
+                    b_pack.resize(std::max(b_pack.size(), nc_max * KC));
+
+                    linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                                         (a_pack.size() + b_pack.size()) * sizeof(T));
+                }
+
+                std::size_t ic = (task / tiles_n) * mc_max;
+                std::size_t jc = (task % tiles_n) * nc_max;
+                std::size_t mc = std::min(mc_max, M - ic);
+                std::size_t nc = std::min(nc_max, N - jc);
+
+                for (std::size_t pc = 0; pc < K; pc += KC) {
+                    std::size_t kc = std::min(KC, K - pc);
+
+                    pack_b<T, NR>(kc, nc, B + pc * ldb + jc, ldb, b_pack.data());
+                    pack_a<T, MR>(mc, kc, A + ic * lda + pc, lda, a_pack.data());
+
+                    for (std::size_t jr = 0; jr < nc; jr += NR) {
+                        std::size_t n_eff = std::min(NR, nc - jr);
+                        const T* bp = b_pack.data() + jr * kc;
+
+                        for (std::size_t ir = 0; ir < mc; ir += MR) {
+                            std::size_t m_eff = std::min(MR, mc - ir);
+                            const T* ap = a_pack.data() + ir * kc;
+                            T* c = C + (ic + ir) * ldc + jc + jr;
+
+                            if (m_eff == MR && n_eff == NR) {
+                                kernel(kc, ap, bp, c, ldc);
+                                continue;
+                            }
+
+                            // Edge tile: compute into a scratch block, then copy the valid part
+                            T edge[MR * NR] = {};
+                            kernel(kc, ap, bp, edge, NR);
+
+                            for (std::size_t r = 0; r < m_eff; ++r) {
+                                for (std::size_t s = 0; s < n_eff; ++s) {
+                                    c[r * ldc + s] += edge[r * NR + s];
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+    }
+
+    // C (M x N, row stride ldc) += A (M x K, stride lda) * B (K x N, stride ldb)
+    template<typename T>
+    void gemm(std::size_t M, std::size_t N, std::size_t K,
+              const T* A, std::size_t lda,
+              const T* B, std::size_t ldb,
+              T* C, std::size_t ldc) {
+        using namespace gemm_detail;
+
+        if (M == 0 || N == 0 || K == 0) return;
+
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::gemm);
+        linalg::metrics::add(linalg::metrics::Counter::flops, 2 * M * N * K);
+
+#if LINALG_X86_KERNELS
+        constexpr bool simd_type = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                                   std::is_same_v<T, int>;
+
+        if constexpr (simd_type) {
+            switch (detected_isa()) {
+                case Isa::avx512: {
+                    constexpr std::size_t W = 64 / sizeof(T);
+                    gemm_blocked<T, 6, 2 * W>(M, N, K, A, lda, B, ldb, C, ldc, &kernel_avx512<T, W>);
+                    return;
+                }
+                case Isa::avx2: {
+                    constexpr std::size_t W = 32 / sizeof(T);
+                    gemm_blocked<T, 6, 2 * W>(M, N, K, A, lda, B, ldb, C, ldc, &kernel_avx2<T, W>);
+                    return;
+                }
+                case Isa::generic:
+                    break;
+            }
+        }
+#endif
+
+        gemm_blocked<T, 4, 4>(M, N, K, A, lda, B, ldb, C, ldc, &kernel_generic<T, 4, 4>);
+    }
+
+    // y (M) = A (M x N, row stride lda) * x (N), rows split over the thread pool
+    template<typename T>
+    void gemv(std::size_t M, std::size_t N, const T* A, std::size_t lda, const T* x, T* y) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::gemv);
+        linalg::metrics::add(linalg::metrics::Counter::flops, 2 * M * N);
+
+        constexpr std::size_t rows_per_task = 64;
+        std::size_t tasks = (M + rows_per_task - 1) / rows_per_task;
+
+        linalg::parallel::parallel_for(tasks, [&](std::size_t task, std::size_t) {
+            std::size_t end = std::min(M, (task + 1) * rows_per_task);
+
+            for (std::size_t i = task * rows_per_task; i < end; ++i) {
+                const T* row = A + i * lda;
+                T acc = T(0);
+
+                for (std::size_t j = 0; j < N; ++j) acc += row[j] * x[j];
+                y[i] = acc;
+            }
+        });
+    }
+
+}
+
+#endif // GEMM_KERNELS_HXX
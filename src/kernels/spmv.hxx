@@ -0,0 +1,371 @@
+#pragma once
+
+#ifndef SPMV_KERNELS_HXX
+#define SPMV_KERNELS_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "gemm.hxx"
+#include "../parallel/thread_pool.hxx"
+#include "../diagnostics/metrics.hxx"
+
+#if LINALG_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+// Sparse matrix-vector (SpMV) and sparse matrix-dense matrix (SpMM) kernels
+// over the compressed layouts.
+//
+// Both kernels work on the generic "compressed outer" layout shared by CRS
+// (outer = rows, inner = columns) and CCS (outer = columns, inner = rows).
+// On CRS that gives y = A * x, on CCS the same gather gives y = A^T * x, so
+// neither direction ever needs a scatter or atomic update.
+//
+// Outer slices are split into chunks holding roughly the same number of
+// nonzeros and the chunks are handed to the thread pool.
+
+namespace linalg::kernels {
+
+    namespace spmv_detail {
+
+        // Below this many nonzeros the pool wake-up costs more than it saves
+        inline constexpr std::size_t PARALLEL_NNZ_THRESHOLD = 1 << 14;
+        // Chunks per thread, to even out rows with skewed lengths
+        inline constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+        template<typename T, typename I>
+        T dot_gather_generic(const T* vals, const I* idx, std::size_t n, const T* x) {
+            T acc0 = T(0), acc1 = T(0);
+            std::size_t k = 0;
+
+            for (; k + 2 <= n; k += 2) {
+                acc0 += vals[k] * x[idx[k]];
+                acc1 += vals[k + 1] * x[idx[k + 1]];
+            }
+            if (k < n) acc0 += vals[k] * x[idx[k]];
+
+            return acc0 + acc1;
+        }
+
+#if LINALG_X86_KERNELS
+        __attribute__((target("avx2,fma")))
+        inline double dot_gather_avx2(const double* vals, const long long* idx, std::size_t n, const double* x) {
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            std::size_t k = 0;
+
+            for (; k + 8 <= n; k += 8) {
+                __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+                __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k + 4));
+                acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(vals + k), _mm256_i64gather_pd(x, i0, 8), acc0);
+                acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(vals + k + 4), _mm256_i64gather_pd(x, i1, 8), acc1);
+            }
+
+            acc0 = _mm256_add_pd(acc0, acc1);
+            __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+            double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline float dot_gather_avx2(const float* vals, const long long* idx, std::size_t n, const float* x) {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            std::size_t k = 0;
+
+            for (; k + 8 <= n; k += 8) {
+                __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+                __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k + 4));
+                acc0 = _mm_fmadd_ps(_mm_loadu_ps(vals + k), _mm256_i64gather_ps(x, i0, 4), acc0);
+                acc1 = _mm_fmadd_ps(_mm_loadu_ps(vals + k + 4), _mm256_i64gather_ps(x, i1, 4), acc1);
+            }
+
+            acc0 = _mm_add_ps(acc0, acc1);
+            acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+            float sum = _mm_cvtss_f32(_mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1)));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx512f,fma")))
+        inline double dot_gather_avx512(const double* vals, const long long* idx, std::size_t n, const double* x) {
+            __m512d acc0 = _mm512_setzero_pd();
+            __m512d acc1 = _mm512_setzero_pd();
+            std::size_t k = 0;
+
+            for (; k + 16 <= n; k += 16) {
+                __m512i i0 = _mm512_loadu_si512(idx + k);
+                __m512i i1 = _mm512_loadu_si512(idx + k + 8);
+                acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k), _mm512_i64gather_pd(i0, x, 8), acc0);
+                acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k + 8), _mm512_i64gather_pd(i1, x, 8), acc1);
+            }
+            if (k + 8 <= n) {
+                __m512i i0 = _mm512_loadu_si512(idx + k);
+                acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k), _mm512_i64gather_pd(i0, x, 8), acc0);
+                k += 8;
+            }
+
+            double sum = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx512f,fma")))
+        inline float dot_gather_avx512(const float* vals, const long long* idx, std::size_t n, const float* x) {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            std::size_t k = 0;
+
+            for (; k + 16 <= n; k += 16) {
+                __m512i i0 = _mm512_loadu_si512(idx + k);
+                __m512i i1 = _mm512_loadu_si512(idx + k + 8);
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(vals + k), _mm512_i64gather_ps(i0, x, 4), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(vals + k + 8), _mm512_i64gather_ps(i1, x, 4), acc1);
+            }
+
+            acc0 = _mm256_add_ps(acc0, acc1);
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+            half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+            float sum = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        // 32-bit indexes: half the index bandwidth of the 64-bit kernels above
+        __attribute__((target("avx2,fma")))
+        inline double dot_gather_avx2(const double* vals, const int* idx, std::size_t n, const double* x) {
+            __m256d acc0 = _mm256_setzero_pd();
+            __m256d acc1 = _mm256_setzero_pd();
+            std::size_t k = 0;
+
+            for (; k + 8 <= n; k += 8) {
+                __m256i i01 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+                acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(vals + k),
+                                       _mm256_i32gather_pd(x, _mm256_castsi256_si128(i01), 8), acc0);
+                acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(vals + k + 4),
+                                       _mm256_i32gather_pd(x, _mm256_extracti128_si256(i01, 1), 8), acc1);
+            }
+
+            acc0 = _mm256_add_pd(acc0, acc1);
+            __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc0), _mm256_extractf128_pd(acc0, 1));
+            double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline float dot_gather_avx2(const float* vals, const int* idx, std::size_t n, const float* x) {
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            std::size_t k = 0;
+
+            for (; k + 16 <= n; k += 16) {
+                __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+                __m256i i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k + 8));
+                acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(vals + k), _mm256_i32gather_ps(x, i0, 4), acc0);
+                acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(vals + k + 8), _mm256_i32gather_ps(x, i1, 4), acc1);
+            }
+
+            acc0 = _mm256_add_ps(acc0, acc1);
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc0), _mm256_extractf128_ps(acc0, 1));
+            half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+            float sum = _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx512f,fma")))
+        inline double dot_gather_avx512(const double* vals, const int* idx, std::size_t n, const double* x) {
+            __m512d acc0 = _mm512_setzero_pd();
+            __m512d acc1 = _mm512_setzero_pd();
+            std::size_t k = 0;
+
+            for (; k + 16 <= n; k += 16) {
+                __m512i i01 = _mm512_loadu_si512(idx + k);
+                acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k),
+                                       _mm512_i32gather_pd(_mm512_castsi512_si256(i01), x, 8), acc0);
+                acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k + 8),
+                                       _mm512_i32gather_pd(_mm512_extracti64x4_epi64(i01, 1), x, 8), acc1);
+            }
+            if (k + 8 <= n) {
+                __m256i i0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx + k));
+                acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(vals + k), _mm512_i32gather_pd(i0, x, 8), acc0);
+                k += 8;
+            }
+
+            double sum = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        __attribute__((target("avx512f,fma")))
+        inline float dot_gather_avx512(const float* vals, const int* idx, std::size_t n, const float* x) {
+            __m512 acc0 = _mm512_setzero_ps();
+            __m512 acc1 = _mm512_setzero_ps();
+            std::size_t k = 0;
+
+            for (; k + 32 <= n; k += 32) {
+                __m512i i0 = _mm512_loadu_si512(idx + k);
+                __m512i i1 = _mm512_loadu_si512(idx + k + 16);
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(vals + k), _mm512_i32gather_ps(i0, x, 4), acc0);
+                acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(vals + k + 16), _mm512_i32gather_ps(i1, x, 4), acc1);
+            }
+            if (k + 16 <= n) {
+                __m512i i0 = _mm512_loadu_si512(idx + k);
+                acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(vals + k), _mm512_i32gather_ps(i0, x, 4), acc0);
+                k += 16;
+            }
+
+            float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+
+            for (; k < n; ++k) sum += vals[k] * x[idx[k]];
+            return sum;
+        }
+
+        template<typename T, typename I>
+        inline constexpr bool has_simd_gather =
+            (std::is_same_v<T, double> || std::is_same_v<T, float>) &&
+            (std::is_same_v<I, long long> || std::is_same_v<I, int>);
+
+        // Row loops live in their own `target` functions so the gathers above inline into them
+        template<typename T, typename I>
+        __attribute__((target("avx2,fma")))
+        void spmv_range_avx2(std::size_t begin, std::size_t end, const I* ptr, const I* idx,
+                             const T* vals, const T* x, T* y) {
+            for (std::size_t i = begin; i < end; ++i) {
+                y[i] = dot_gather_avx2(vals + ptr[i], idx + ptr[i], ptr[i + 1] - ptr[i], x);
+            }
+        }
+
+        template<typename T, typename I>
+        __attribute__((target("avx512f,fma")))
+        void spmv_range_avx512(std::size_t begin, std::size_t end, const I* ptr, const I* idx,
+                               const T* vals, const T* x, T* y) {
+            for (std::size_t i = begin; i < end; ++i) {
+                y[i] = dot_gather_avx512(vals + ptr[i], idx + ptr[i], ptr[i + 1] - ptr[i], x);
+            }
+        }
+#endif
+
+        template<typename T, typename I>
+        void spmv_range(std::size_t begin, std::size_t end, const I* ptr, const I* idx,
+                        const T* vals, const T* x, T* y) {
+#if LINALG_X86_KERNELS
+            if constexpr (has_simd_gather<T, I>) {
+                switch (detected_isa()) {
+                    case Isa::avx512: spmv_range_avx512(begin, end, ptr, idx, vals, x, y); return;
+                    case Isa::avx2:   spmv_range_avx2(begin, end, ptr, idx, vals, x, y);   return;
+                    case Isa::generic: break;
+                }
+            }
+#endif
+            for (std::size_t i = begin; i < end; ++i) {
+                y[i] = dot_gather_generic(vals + ptr[i], idx + ptr[i], std::size_t(ptr[i + 1] - ptr[i]), x);
+            }
+        }
+
+    }
+
+    // Splits outer slices [0, n_outer) into `parts` contiguous ranges of about
+    // equal cost, counting one unit per nonzero plus one per slice.
+    // Returns `parts + 1` boundaries.
+    template<typename I>
+    std::vector<std::size_t> balanced_partition(std::size_t n_outer, const I* ptr, std::size_t parts) {
+        std::vector<std::size_t> bounds(parts + 1, n_outer);
+        bounds[0] = 0;
+
+        std::size_t total = static_cast<std::size_t>(ptr[n_outer] - ptr[0]) + n_outer;
+
+        for (std::size_t p = 1; p < parts; ++p) {
+            std::size_t target = total * p / parts;
+            std::size_t lo = bounds[p - 1], hi = n_outer;
+
+            // First slice whose prefix cost reaches `target`
+            while (lo < hi) {
+                std::size_t mid = lo + (hi - lo) / 2;
+                std::size_t cost = static_cast<std::size_t>(ptr[mid] - ptr[0]) + mid;
+                if (cost < target) lo = mid + 1;
+                else hi = mid;
+            }
+            bounds[p] = lo;
+        }
+
+        return bounds;
+    }
+
+    // Runs `fn(begin, end)` over nnz-balanced outer ranges on the thread pool
+    template<typename I, typename F>
+    void for_each_balanced_range(std::size_t n_outer, const I* ptr, F&& fn) {
+        if (n_outer == 0) return;
+
+        std::size_t nnz = static_cast<std::size_t>(ptr[n_outer] - ptr[0]);
+        std::size_t threads = linalg::parallel::pool().size();
+
+        if (threads == 1 || nnz < spmv_detail::PARALLEL_NNZ_THRESHOLD) {
+            fn(std::size_t(0), n_outer);
+            return;
+        }
+
+        std::size_t parts = std::min(n_outer, threads * spmv_detail::CHUNKS_PER_THREAD);
+        std::vector<std::size_t> bounds = balanced_partition(n_outer, ptr, parts);
+
+        linalg::parallel::parallel_for(parts, [&](std::size_t part, std::size_t) {
+            if (bounds[part] < bounds[part + 1]) fn(bounds[part], bounds[part + 1]);
+        });
+    }
+
+    // y[i] = sum_k vals[k] * x[idx[k]] over k in [ptr[i], ptr[i + 1]), for i in [0, n_outer)
+    template<typename T, typename I>
+    void spmv(std::size_t n_outer, const I* ptr, const I* idx, const T* vals, const T* x, T* y) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::spmv);
+        if (n_outer > 0) {
+            std::size_t nnz = static_cast<std::size_t>(ptr[n_outer] - ptr[0]);
+            linalg::metrics::add(linalg::metrics::Counter::nnz_touched, nnz);
+            linalg::metrics::add(linalg::metrics::Counter::flops, 2 * nnz);
+        }
+
+        for_each_balanced_range(n_outer, ptr, [&](std::size_t begin, std::size_t end) {
+            spmv_detail::spmv_range(begin, end, ptr, idx, vals, x, y);
+        });
+    }
+
+    // Y (n_outer x k, row stride ldy) = A * X (row stride ldx), A in the compressed
+    // layout above. Each nonzero adds a scaled contiguous row of X into Y.
+    template<typename T, typename I>
+    void spmm(std::size_t n_outer, const I* ptr, const I* idx, const T* vals,
+              std::size_t k, const T* X, std::size_t ldx, T* Y, std::size_t ldy) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::spmm);
+        if (n_outer > 0) {
+            std::size_t nnz = static_cast<std::size_t>(ptr[n_outer] - ptr[0]);
+            linalg::metrics::add(linalg::metrics::Counter::nnz_touched, nnz);
+            linalg::metrics::add(linalg::metrics::Counter::flops, 2 * nnz * k);
+        }
+
+        for_each_balanced_range(n_outer, ptr, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                T* y = Y + i * ldy;
+                std::fill(y, y + k, T(0));
+
+                for (I p = ptr[i]; p < ptr[i + 1]; ++p) {
+                    const T v = vals[p];
+                    const T* x = X + static_cast<std::size_t>(idx[p]) * ldx;
+
+                    for (std::size_t c = 0; c < k; ++c) y[c] += v * x[c];
+                }
+            }
+        });
+    }
+
+}
+
+#endif // SPMV_KERNELS_HXX
@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef TRANSPOSE_KERNELS_HXX
+#define TRANSPOSE_KERNELS_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "spmv.hxx"
+#include "../parallel/thread_pool.hxx"
+#include "../diagnostics/metrics.hxx"
+
+// Compressed transpose: CRS arrays in, CCS arrays of the same matrix out
+// (and the other way round, the layouts are symmetric).
+//
+// The outer slices are split into nnz-balanced parts. Each part counts its
+// inner indexes into a private histogram, a column-wise prefix over the parts
+// turns the histograms into write cursors, and every part then scatters its
+// own entries. Parts are ordered and each walks its slices in order, so the
+// output is sorted within every slice and independent of the thread count.
+
+namespace linalg::kernels {
+
+    namespace transpose_detail {
+
+        // Below this many nonzeros the serial counting sort is faster
+        inline constexpr std::size_t PARALLEL_NNZ_THRESHOLD = 1 << 15;
+
+        // Inner slices per task when turning the histograms into cursors
+        inline constexpr std::size_t PREFIX_BLOCK = 1 << 12;
+
+    }
+
+    // Transposes the compressed (n_outer x n_inner) arrays `ptr` / `idx` / `vals`.
+    // `out_ptr` holds n_inner + 1 entries, `out_idx` and `out_vals` nnz each.
+    template<typename T, typename I>
+    void transpose(std::size_t n_outer, std::size_t n_inner,
+                   const I* ptr, const I* idx, const T* vals,
+                   I* out_ptr, I* out_idx, T* out_vals) {
+        std::fill(out_ptr, out_ptr + n_inner + 1, static_cast<I>(0));
+        if (n_outer == 0) return;
+
+        std::size_t nnz = static_cast<std::size_t>(ptr[n_outer] - ptr[0]);
+        std::size_t threads = linalg::parallel::pool().size();
+
+        linalg::metrics::add(linalg::metrics::Counter::nnz_touched, nnz);
+
+        // One histogram of n_inner entries per part; keep them within ~nnz in total
+        std::size_t parts = std::min({threads, n_outer, std::max<std::size_t>(1, nnz / std::max<std::size_t>(1, n_inner))});
+
+        if (parts <= 1 || nnz < transpose_detail::PARALLEL_NNZ_THRESHOLD) {
+            for (std::size_t k = 0; k < nnz; ++k) ++out_ptr[idx[ptr[0] + k] + 1];
+            for (std::size_t c = 0; c < n_inner; ++c) out_ptr[c + 1] += out_ptr[c];
+
+            std::vector<I> cursor(out_ptr, out_ptr + n_inner);
+            for (std::size_t i = 0; i < n_outer; ++i) {
+                for (I k = ptr[i]; k < ptr[i + 1]; ++k) {
+                    I slot = cursor[idx[k]]++;
+                    out_idx[slot] = static_cast<I>(i);
+                    out_vals[slot] = vals[k];
+                }
+            }
+            return;
+        }
+
+        std::vector<std::size_t> bounds = balanced_partition(n_outer, ptr, parts);
+        std::vector<I> cursor(parts * n_inner, static_cast<I>(0));
+
+        linalg::parallel::parallel_for(parts, [&](std::size_t part, std::size_t) {
+            I* count = cursor.data() + part * n_inner;
+            for (I k = ptr[bounds[part]]; k < ptr[bounds[part + 1]]; ++k) ++count[idx[k]];
+        });
+
+        for (std::size_t part = 0; part < parts; ++part) {
+            const I* count = cursor.data() + part * n_inner;
+            for (std::size_t c = 0; c < n_inner; ++c) out_ptr[c + 1] += count[c];
+        }
+        for (std::size_t c = 0; c < n_inner; ++c) out_ptr[c + 1] += out_ptr[c];
+
+        // Part p writes slice c from out_ptr[c] plus the counts of parts before p
+        std::size_t blocks = (n_inner + transpose_detail::PREFIX_BLOCK - 1) / transpose_detail::PREFIX_BLOCK;
+        linalg::parallel::parallel_for(blocks, [&](std::size_t block, std::size_t) {
+            std::size_t end = std::min(n_inner, (block + 1) * transpose_detail::PREFIX_BLOCK);
+
+            for (std::size_t c = block * transpose_detail::PREFIX_BLOCK; c < end; ++c) {
+                I position = out_ptr[c];
+                for (std::size_t part = 0; part < parts; ++part) {
+                    I count = cursor[part * n_inner + c];
+                    cursor[part * n_inner + c] = position;
+                    position += count;
+                }
+            }
+        });
+
+        linalg::parallel::parallel_for(parts, [&](std::size_t part, std::size_t) {
+            I* slot = cursor.data() + part * n_inner;
+
+            for (std::size_t i = bounds[part]; i < bounds[part + 1]; ++i) {
+                for (I k = ptr[i]; k < ptr[i + 1]; ++k) {
+                    I position = slot[idx[k]]++;
+                    out_idx[position] = static_cast<I>(i);
+                    out_vals[position] = vals[k];
+                }
+            }
+        });
+    }
+
+}
+
+#endif // TRANSPOSE_KERNELS_HXX
@@ -0,0 +1,127 @@
+#pragma once
+
+#ifndef VECTOR_KERNELS_HXX
+#define VECTOR_KERNELS_HXX
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "../parallel/thread_pool.hxx"
+#include "../diagnostics/metrics.hxx"
+
+// Dense vector kernels for the iterative solvers.
+//
+// Vectors are cut into fixed blocks of VECTOR_BLOCK elements that run on the
+// thread pool. Reductions keep one partial sum per block and add them up in
+// block order, so results do not depend on the number of threads.
+//
+// The fused forms update a vector and reduce over the updated values in the
+// same pass (`y += a * x` followed by `y . z`), which reads every operand once
+// instead of twice.
+
+namespace linalg::kernels {
+
+    inline constexpr std::size_t VECTOR_BLOCK = 1 << 14;
+
+    // Calls `fn(begin, end)` for every block of [0, n)
+    template<typename F>
+    void for_each_block(std::size_t n, F&& fn) {
+        std::size_t blocks = (n + VECTOR_BLOCK - 1) / VECTOR_BLOCK;
+
+        linalg::parallel::parallel_for(blocks, [&](std::size_t block, std::size_t) {
+            fn(block * VECTOR_BLOCK, std::min(n, (block + 1) * VECTOR_BLOCK));
+        });
+    }
+
+    // Sum of `fn(begin, end)` over the blocks of [0, n), in block order
+    template<typename T, typename F>
+    T reduce_blocks(std::size_t n, F&& fn) {
+        std::size_t blocks = (n + VECTOR_BLOCK - 1) / VECTOR_BLOCK;
+        if (blocks <= 1) return n == 0 ? T(0) : fn(std::size_t(0), n);
+
+        std::vector<T> partial(blocks);
+
+        linalg::parallel::parallel_for(blocks, [&](std::size_t block, std::size_t) {
+            partial[block] = fn(block * VECTOR_BLOCK, std::min(n, (block + 1) * VECTOR_BLOCK));
+        });
+
+        T sum = T(0);
+        for (const T& value : partial) sum += value;
+        return sum;
+    }
+
+    // x . y
+    template<typename T>
+    T dot(std::size_t n, const T* x, const T* y) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, 2 * n);
+
+        return reduce_blocks<T>(n, [&](std::size_t begin, std::size_t end) {
+            T sum = T(0);
+            for (std::size_t i = begin; i < end; ++i) sum += x[i] * y[i];
+            return sum;
+        });
+    }
+
+    // y += a * x
+    template<typename T>
+    void axpy(std::size_t n, T a, const T* x, T* y) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, 2 * n);
+
+        for_each_block(n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) y[i] += a * x[i];
+        });
+    }
+
+    // y = x + b * y
+    template<typename T>
+    void xpby(std::size_t n, const T* x, T b, T* y) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, 2 * n);
+
+        for_each_block(n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) y[i] = x[i] + b * y[i];
+        });
+    }
+
+    // x *= a
+    template<typename T>
+    void scale(std::size_t n, T a, T* x) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, n);
+
+        for_each_block(n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) x[i] *= a;
+        });
+    }
+
+    // y += a * x, then returns y . z over the updated y (z may alias y)
+    template<typename T>
+    T axpy_dot(std::size_t n, T a, const T* x, T* y, const T* z) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, 4 * n);
+
+        return reduce_blocks<T>(n, [&](std::size_t begin, std::size_t end) {
+            T sum = T(0);
+            for (std::size_t i = begin; i < end; ++i) {
+                y[i] += a * x[i];
+                sum += y[i] * z[i];
+            }
+            return sum;
+        });
+    }
+
+    // r = b - q, then returns r . r (residual of a product q = A * x)
+    template<typename T>
+    T sub_norm2(std::size_t n, const T* b, const T* q, T* r) {
+        linalg::metrics::add(linalg::metrics::Counter::flops, 3 * n);
+
+        return reduce_blocks<T>(n, [&](std::size_t begin, std::size_t end) {
+            T sum = T(0);
+            for (std::size_t i = begin; i < end; ++i) {
+                r[i] = b[i] - q[i];
+                sum += r[i] * r[i];
+            }
+            return sum;
+        });
+    }
+
+}
+
+#endif // VECTOR_KERNELS_HXX
@@ -0,0 +1,57 @@
+#pragma once
+
+#ifndef ALIGNED_ALLOCATOR_HXX
+#define ALIGNED_ALLOCATOR_HXX
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace linalg::detail {
+
+    // Cache line / AVX-512 register width in bytes
+    inline constexpr std::size_t DENSE_ALIGNMENT = 64;
+
+    // Minimal allocator returning `Alignment`-aligned blocks, so rows of the
+    // dense buffer start on cache line boundaries and SIMD loads never split.
+    template<typename T, std::size_t Alignment = DENSE_ALIGNMENT>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+
+        template<typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* ptr, std::size_t) noexcept {
+            ::operator delete(ptr, std::align_val_t(Alignment));
+        }
+
+        template<typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+        template<typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+    };
+
+    // Number of elements a row is padded to, so every row stays aligned
+    template<typename T>
+    constexpr std::size_t padded_leading_dim(std::size_t cols) {
+        constexpr std::size_t step = DENSE_ALIGNMENT % sizeof(T) == 0 ? DENSE_ALIGNMENT / sizeof(T) : 1;
+        return (cols + step - 1) / step * step;
+    }
+
+}
+
+#endif // ALIGNED_ALLOCATOR_HXX
@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef MATRIX_FORMAT_HXX
+#define MATRIX_FORMAT_HXX
+
+#include <stdexcept>
+#include <string>
+#include "../../include/linalg/linalg.hxx"
+#include "../diagnostics/log.hxx"
+
+namespace linalg {
+
+    // Maps the `sparse` strings of the Matrix constructors to a Format:
+    // "CRS" / "CSR", "CCS" / "CSC", "COO", "def" and "all"
+    inline Format parse_format(const std::string& sparse) {
+        if (sparse == "CRS" || sparse == "CSR") return Format::CRS;
+        if (sparse == "CCS" || sparse == "CSC") return Format::CCS;
+        if (sparse == "COO")                    return Format::COO;
+        if (sparse == "def")                    return Format::Dense;
+        if (sparse == "all")                    return Format::All;
+
+        LINALG_LOG_ERROR("Unknown matrix format `{}`", sparse);
+        throw std::logic_error("Unknown matrix format `" + sparse + "`.");
+    }
+
+    // `Matrix<T>` holds one of the concrete states, never Format::Dynamic itself
+    inline Format runtime_format(Format format) {
+        if (format != Format::Dynamic) return format;
+
+        LINALG_LOG_ERROR("Format::Dynamic is not a storage format");
+        throw std::logic_error("Format::Dynamic is not a storage format.");
+    }
+
+    inline const char* format_name(Format format) {
+        switch (format) {
+            case Format::Dynamic: return "dynamic";
+            case Format::Dense:   return "def";
+            case Format::CRS:     return "CRS";
+            case Format::CCS:     return "CCS";
+            case Format::COO:     return "COO";
+            case Format::All:     return "all";
+        }
+        return "unknown";
+    }
+
+}
+
+#endif // MATRIX_FORMAT_HXX
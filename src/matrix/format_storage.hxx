@@ -0,0 +1,47 @@
+#pragma once
+
+#ifndef MATRIX_FORMAT_STORAGE_HXX
+#define MATRIX_FORMAT_STORAGE_HXX
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "../../include/linalg/linalg.hxx"
+#include "aligned_allocator.hxx"
+#include "sparse_array.hxx"
+
+namespace linalg::detail {
+
+    // Storage of `Matrix<T, F, I>`, one representation per format
+
+    template<typename T>
+    struct DenseStorage {
+        // Row-major, element (i, j) at `data[i * ld + j]`, rows padded to `ld`
+        std::vector<T, AlignedAllocator<T>>     data;
+        std::size_t                             ld = 0;
+    };
+
+    // CRS: outer = rows, inner = columns. CCS: outer = columns, inner = rows.
+    template<typename T, typename I>
+    struct CompressedStorage {
+        SparseArray<I>                          pointers;
+        SparseArray<I>                          indexes;
+        SparseArray<T>                          values;
+    };
+
+    template<typename T, typename I>
+    struct TripletStorage {
+        std::vector<I>                          row_indexes;
+        std::vector<I>                          col_indexes;
+        std::vector<T>                          values;
+    };
+
+    template<typename T, Format F, typename I>
+    using format_storage_t =
+        std::conditional_t<F == Format::Dense, DenseStorage<T>,
+        std::conditional_t<F == Format::COO, TripletStorage<T, I>,
+                           CompressedStorage<T, I>>>;
+
+}
+
+#endif // MATRIX_FORMAT_STORAGE_HXX
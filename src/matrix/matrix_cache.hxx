@@ -0,0 +1,264 @@
+#pragma once
+
+#ifndef MATRIX_CACHE_HXX
+#define MATRIX_CACHE_HXX
+
+#include "../../include/linalg/matrix.hxx"
+#include "../kernels/transpose.hxx"
+#include <algorithm>
+#include <cstddef>
+
+namespace linalg::detail {
+
+    // Outer slices handed to one task when compressing a dense buffer
+    inline constexpr std::size_t DENSE_COMPRESS_BLOCK = 64;
+
+    // Compresses the nonzeros of a row-major buffer by rows (CRS) or by
+    // columns (CCS). Column blocks are scanned row by row, so both layouts
+    // read the buffer contiguously.
+    template<typename T, typename I>
+    void compress_dense(std::size_t rows, std::size_t cols, const T* data, std::size_t ld, bool by_rows,
+                        SparseArray<I>& ptr, SparseArray<I>& idx, SparseArray<T>& vals) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
+
+        std::size_t n_outer = by_rows ? rows : cols;
+        std::size_t blocks = (n_outer + DENSE_COMPRESS_BLOCK - 1) / DENSE_COMPRESS_BLOCK;
+
+        ptr.assign(n_outer + 1, static_cast<I>(0));
+
+        // `fn(outer, inner, value)` over the nonzeros of one block, sorted by inner index within each outer slice
+        auto scan = [&](std::size_t block, auto&& fn) {
+            std::size_t begin = block * DENSE_COMPRESS_BLOCK;
+            std::size_t end = std::min(n_outer, begin + DENSE_COMPRESS_BLOCK);
+
+            if (by_rows) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    for (std::size_t j = 0; j < cols; ++j) {
+                        if (data[i * ld + j] != static_cast<T>(0)) fn(i, j, data[i * ld + j]);
+                    }
+                }
+            }
+            else {
+                for (std::size_t i = 0; i < rows; ++i) {
+                    for (std::size_t j = begin; j < end; ++j) {
+                        if (data[i * ld + j] != static_cast<T>(0)) fn(j, i, data[i * ld + j]);
+                    }
+                }
+            }
+        };
+
+        I* counts = ptr.data();
+        linalg::parallel::parallel_for(blocks, [&](std::size_t block, std::size_t) {
+            scan(block, [&](std::size_t outer, std::size_t, const T&) { ++counts[outer + 1]; });
+        });
+
+        for (std::size_t o = 0; o < n_outer; ++o) ptr[o + 1] += ptr[o];
+
+        std::size_t nnz = static_cast<std::size_t>(ptr[n_outer]);
+        idx.resize(nnz);
+        vals.resize(nnz);
+
+        std::vector<I> cursor(ptr.begin(), ptr.end() - 1);
+        I* out_idx = idx.data();
+        T* out_vals = vals.data();
+
+        linalg::parallel::parallel_for(blocks, [&](std::size_t block, std::size_t) {
+            scan(block, [&](std::size_t outer, std::size_t inner, const T& value) {
+                I slot = cursor[outer]++;
+                out_idx[slot] = static_cast<I>(inner);
+                out_vals[slot] = value;
+            });
+        });
+
+        linalg::metrics::add(linalg::metrics::Counter::nnz_touched, nnz);
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                             nnz * (sizeof(T) + sizeof(I)) + ptr.size() * sizeof(I));
+    }
+
+    // CRS arrays -> CCS arrays of the same matrix, or the other way round
+    template<typename T, typename I>
+    void transpose_compressed(std::size_t n_outer, std::size_t n_inner,
+                              const SparseArray<I>& ptr, const SparseArray<I>& idx, const SparseArray<T>& vals,
+                              SparseArray<I>& out_ptr, SparseArray<I>& out_idx, SparseArray<T>& out_vals) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
+
+        out_ptr.resize(n_inner + 1);
+        out_idx.resize(vals.size());
+        out_vals.resize(vals.size());
+
+        linalg::kernels::transpose<T, I>(n_outer, n_inner, ptr.data(), idx.data(), vals.data(),
+                                         out_ptr.data(), out_idx.data(), out_vals.data());
+
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                             vals.size() * (sizeof(T) + sizeof(I)) + out_ptr.size() * sizeof(I));
+    }
+
+}
+
+#pragma region Matrix Format Cache
+
+template<typename T>
+linalg::Format linalg::Matrix<T>::authority() const {
+    return matrix_state == linalg::Format::All ? linalg::Format::Dense : matrix_state;
+}
+
+template<typename T>
+typename linalg::Matrix<T>::CachedVersions&
+linalg::Matrix<T>::CachedVersions::operator=(const CachedVersions& _oth) {
+    dense.store(_oth.dense.load(std::memory_order_acquire), std::memory_order_relaxed);
+    crs.store(_oth.crs.load(std::memory_order_acquire), std::memory_order_relaxed);
+    ccs.store(_oth.ccs.load(std::memory_order_acquire), std::memory_order_relaxed);
+    coo.store(_oth.coo.load(std::memory_order_acquire), std::memory_order_relaxed);
+    return *this;
+}
+
+template<typename T>
+bool linalg::Matrix<T>::is_current(linalg::Format format) const {
+    if (format == authority()) return true;
+
+    switch (format) {
+        case linalg::Format::Dense: return cached.dense.load(std::memory_order_acquire) == version;
+        case linalg::Format::CRS:   return cached.crs.load(std::memory_order_acquire) == version;
+        case linalg::Format::CCS:   return cached.ccs.load(std::memory_order_acquire) == version;
+        case linalg::Format::COO:   return cached.coo.load(std::memory_order_acquire) == version;
+        default:                    return false;
+    }
+}
+
+template<typename T>
+void linalg::Matrix<T>::invalidate_caches() {
+    ++version;
+
+    linalg::Format source = authority();
+    if (source != linalg::Format::Dense && !matrix.empty()) matrix = DenseBuffer();
+    if (source != linalg::Format::CRS && !crs_matrix.row_pointers.empty()) crs_matrix = CRS();
+    if (source != linalg::Format::CCS && !ccs_matrix.col_pointers.empty()) ccs_matrix = CCS();
+    if (source != linalg::Format::COO && !coo_matrix.values.empty()) coo_matrix = COO();
+}
+
+template<typename T>
+void linalg::Matrix<T>::sync_dense() const {
+    // Checked again under the lock: another thread may have built it meanwhile
+    if (is_current(linalg::Format::Dense)) return;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+
+    // Matrices assembled from triplets start without a dense buffer
+    if (matrix.size() != static_cast<std::size_t>(rows) * ld) {
+        matrix.assign(static_cast<std::size_t>(rows) * ld, static_cast<T>(0));
+
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated, matrix.size() * sizeof(T));
+    }
+    else if (is_current(linalg::Format::Dense)) {
+        return;
+    }
+
+    linalg::Format source = authority();
+    if (source == linalg::Format::Dense) return;
+
+    LINALG_LOG_DEBUG("Materializing the dense buffer from {}", linalg::format_name(source));
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+    std::fill(matrix.begin(), matrix.end(), static_cast<T>(0));
+
+    // Const views: a non-const read would copy arrays borrowed from a mapped file
+    const CRS& crs = crs_matrix;
+    const CCS& ccs = ccs_matrix;
+
+    if (source == linalg::Format::CRS && !crs.row_pointers.empty()) {
+        for (std::size_t i = 0; i + 1 < crs.row_pointers.size(); ++i) {
+            for (long long idx = crs.row_pointers[i]; idx < crs.row_pointers[i + 1]; ++idx) {
+                matrix[i * ld + crs.col_indexes[idx]] = crs.values[idx];
+            }
+        }
+    }
+    else if (source == linalg::Format::CCS && !ccs.col_pointers.empty()) {
+        for (std::size_t j = 0; j + 1 < ccs.col_pointers.size(); ++j) {
+            for (long long idx = ccs.col_pointers[j]; idx < ccs.col_pointers[j + 1]; ++idx) {
+                matrix[ccs.row_indexes[idx] * ld + j] = ccs.values[idx];
+            }
+        }
+    }
+    else if (source == linalg::Format::COO) {
+        for (std::size_t idx = 0; idx < coo_matrix.values.size(); ++idx) {
+            matrix[coo_matrix.row_indexes[idx] * ld + coo_matrix.col_indexes[idx]] += coo_matrix.values[idx];
+        }
+    }
+
+    cached.dense.store(version, std::memory_order_release);
+}
+
+template<typename T>
+const typename linalg::Matrix<T>::CRS& linalg::Matrix<T>::crs() const {
+    if (is_current(linalg::Format::CRS)) return crs_matrix;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (is_current(linalg::Format::CRS)) return crs_matrix;
+
+    linalg::Format source = authority();
+    LINALG_LOG_DEBUG("Materializing CRS from {}", linalg::format_name(source));
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+
+    if (source == linalg::Format::CCS) {
+        linalg::detail::transpose_compressed(cols, rows, ccs_matrix.col_pointers, ccs_matrix.row_indexes, ccs_matrix.values,
+                                             crs_matrix.row_pointers, crs_matrix.col_indexes, crs_matrix.values);
+    }
+    else if (source == linalg::Format::COO) {
+        crs_matrix = coo_matrix.to_crs();
+    }
+    else {
+        // Dense is authoritative here, so this neither builds nor locks
+        sync_dense();
+        linalg::detail::compress_dense(rows, cols, matrix.data(), ld, true,
+                                       crs_matrix.row_pointers, crs_matrix.col_indexes, crs_matrix.values);
+    }
+
+    cached.crs.store(version, std::memory_order_release);
+    return crs_matrix;
+}
+
+template<typename T>
+const typename linalg::Matrix<T>::CCS& linalg::Matrix<T>::ccs() const {
+    if (is_current(linalg::Format::CCS)) return ccs_matrix;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (is_current(linalg::Format::CCS)) return ccs_matrix;
+
+    linalg::Format source = authority();
+    LINALG_LOG_DEBUG("Materializing CCS from {}", linalg::format_name(source));
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+
+    if (source == linalg::Format::CRS) {
+        linalg::detail::transpose_compressed(rows, cols, crs_matrix.row_pointers, crs_matrix.col_indexes, crs_matrix.values,
+                                             ccs_matrix.col_pointers, ccs_matrix.row_indexes, ccs_matrix.values);
+    }
+    else if (source == linalg::Format::COO) {
+        ccs_matrix = coo_matrix.to_ccs();
+    }
+    else {
+        sync_dense();
+        linalg::detail::compress_dense(rows, cols, matrix.data(), ld, false,
+                                       ccs_matrix.col_pointers, ccs_matrix.row_indexes, ccs_matrix.values);
+    }
+
+    cached.ccs.store(version, std::memory_order_release);
+    return ccs_matrix;
+}
+
+template<typename T>
+const typename linalg::Matrix<T>::COO& linalg::Matrix<T>::coo() const {
+    if (is_current(linalg::Format::COO)) return coo_matrix;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (is_current(linalg::Format::COO)) return coo_matrix;
+
+    LINALG_LOG_DEBUG("Materializing COO from {}", linalg::format_name(authority()));
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+
+    coo_matrix = collect_triplets();
+    cached.coo.store(version, std::memory_order_release);
+    return coo_matrix;
+}
+
+#pragma endregion
+
+#endif // MATRIX_CACHE_HXX
@@ -4,22 +4,23 @@
 #define MATRIX_CONSTRUCTORS_HXX
 
 #include "../../include/linalg/matrix.hxx"
+#include "../sparsemtxes/coo.hxx"
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <utility>
 
 #pragma region Matrix Constructors
 
 template <typename T>
 linalg::Matrix<T>::Matrix() {
-    auto logger = spdlog::get("global_logger");
+    LINALG_LOG_DEBUG("Default constructor called, initializing empty matrix.");
 
-    if (logger) {
-        logger->debug("Default constructor called, initializing empty matrix.");
-        logger->flush();  // Ensure logs are written to the file for testing
-    }
-
-    matrix = std::vector<std::vector<T>>(1, std::vector<T>(1));
+    matrix = DenseBuffer(linalg::detail::padded_leading_dim<T>(1));
+    ld = linalg::detail::padded_leading_dim<T>(1);
 
     crs_matrix.values = std::vector<T>();
     crs_matrix.col_indexes = std::vector<long long>();
@@ -33,29 +34,36 @@ linalg::Matrix<T>::Matrix() {
     coo_matrix.values = std::vector<T>();
     coo_matrix.col_indexes = std::vector<long long>();
 
-    matrix_state = "all";
+    matrix_state = linalg::Format::All;
     rows = 1;
     cols = 1;
 }
 
 template<typename T>
-linalg::Matrix<T>::Matrix(const std::vector<std::vector<T>> &_oth, const std::string &sparse) {
-    auto logger = spdlog::get("global_logger");
+linalg::Matrix<T>::Matrix(const std::vector<std::vector<T>> &_oth, const std::string &sparse)
+    : Matrix(_oth, linalg::parse_format(sparse)) {
+}
 
-    if (logger) {
-        logger->debug("Matrix constructor called with sparse format: {}", sparse);
-        logger->flush();
-    }
-    else {
-        std::cerr << "Can't access logger with name global_logger\n";
-    }
+template<typename T>
+linalg::Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> init_matrix, const std::string &sparse)
+    : Matrix(init_matrix, linalg::parse_format(sparse)) {
+}
+
+template<typename T>
+linalg::Matrix<T>::Matrix(const COO& _coo, const std::string& sparse)
+    : Matrix(_coo, linalg::parse_format(sparse)) {
+}
+
+template<typename T>
+linalg::Matrix<T>::Matrix(const std::vector<std::vector<T>> &_oth, linalg::Format format) {
+    LINALG_LOG_DEBUG("Matrix constructor called with sparse format: {}", linalg::format_name(format));
    
     int row_weight = _oth[0].size();
-    logger->debug("Initialized `row_weight` with value [{}]", row_weight);
+    LINALG_LOG_DEBUG("Initialized `row_weight` with value [{}]", row_weight);
 
     for (auto& row: _oth) {
         if (row.size() != row_weight) {
-            logger->error("Matrix is not formed: expected dim (" +
+            LINALG_LOG_ERROR("Matrix is not formed: expected dim (" +
             std::to_string(_oth.size()) + ", " + std::to_string(row_weight) + "). Found: (" +
             std::to_string(_oth.size()) + ", " + std::to_string(row.size()) + ").\n");
 
@@ -65,44 +73,16 @@ linalg::Matrix<T>::Matrix(const std::vector<std::vector<T>> &_oth, const std::st
         }
     }
 
-    matrix = _oth;
-    matrix_state = sparse;
-
-    if (sparse == "CRS") {
-        crs_matrix = linalg::Matrix<T>::init_crs(matrix);
-    }
-    else if (sparse == "CCS") {
-        ccs_matrix = linalg::Matrix<T>::init_ccs(matrix);
-    }
-    else if (sparse == "COO") {
-        coo_matrix = linalg::Matrix<T>::init_coo(matrix);
-    }
-    else if (sparse == "def");
-    else if (sparse == "all") {
-        crs_matrix = linalg::Matrix<T>::init_crs(matrix);
-        ccs_matrix = linalg::Matrix<T>::init_ccs(matrix);
-        coo_matrix = linalg::Matrix<T>::init_coo(matrix);
-    }
-
-    update_rows();
-    update_cols();
-
-    logger->debug("Matrix dimensionality updated to ({}, {})", rows, cols);
-    logger->info("Matrix created. Dimensionality ({}, {})", rows, cols);
+    matrix_state = linalg::runtime_format(format);
+    load_format(_oth);
 
-    logger->flush();
+    LINALG_LOG_DEBUG("Matrix dimensionality updated to ({}, {})", rows, cols);
+    LINALG_LOG_INFO("Matrix created. Dimensionality ({}, {})", rows, cols);
 }
 
 template<typename T>
-linalg::Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> init_matrix, const std::string &sparse) {
-    auto logger = spdlog::get("global_logger");
-
-    if (logger) {
-        logger->debug("Matrix constructor called with sparse format: {}", sparse);
-    }
-    else {
-        std::cerr << "Can't access logger with name global_logger\n";
-    }
+linalg::Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> init_matrix, linalg::Format format) {
+    LINALG_LOG_DEBUG("Matrix constructor called with sparse format: {}", linalg::format_name(format));
     
     auto first_row = init_matrix.begin();
     int row_weight = first_row->size();
@@ -114,57 +94,180 @@ linalg::Matrix<T>::Matrix(std::initializer_list<std::initializer_list<T>> init_m
                 << init_matrix.size() << ", " << row_weight << "). Found: ("
                 << init_matrix.size() << ", " << row.size() << ").";
 
-            logger->error(oss.str());
+            LINALG_LOG_ERROR(oss.str());
             throw std::logic_error(oss.str());
         }
     }
 
-    matrix = std::vector<std::vector<T>>(init_matrix.size());
-    logger->debug("Variable matrix defined with constant count of rows: {}", init_matrix.size());
-    matrix_state = sparse;
+    std::vector<std::vector<T>> rows_list(init_matrix.size());
+    LINALG_LOG_DEBUG("Variable matrix defined with constant count of rows: {}", init_matrix.size());
+    matrix_state = linalg::runtime_format(format);
 
     size_t row = 0;
     for (const auto& row_list : init_matrix) {
-        matrix[row] = std::vector<T>(row_list);
+        rows_list[row] = std::vector<T>(row_list);
         ++row;
     }
 
-    logger->debug("Matrix defined successfully");
+    LINALG_LOG_DEBUG("Matrix defined successfully");
 
-    if (sparse == "CRS") {
-        crs_matrix = linalg::Matrix<T>::init_crs(matrix);
+    load_format(rows_list);
+
+    LINALG_LOG_DEBUG("Matrix dimensionality updated to ({}, {})", rows, cols);
+    LINALG_LOG_INFO("Matrix created. Dimensionality ({}, {})", rows, cols);
+}
+
+template<typename T>
+linalg::Matrix<T>::Matrix(const COO& _coo, linalg::Format format) {
+    LINALG_LOG_DEBUG("Matrix constructor called from COO ({} triplets) with sparse format: {}",
+                     _coo.values.size(), linalg::format_name(format));
+
+    if (_coo.n_rows > INT_MAX || _coo.n_cols > INT_MAX) {
+        LINALG_LOG_ERROR("Matrix dimensionality ({}, {}) exceeds the supported range", _coo.n_rows, _coo.n_cols);
+        throw std::out_of_range("Matrix dimensionality exceeds the supported range.");
     }
-    else if (sparse == "CCS") {
-        ccs_matrix = linalg::Matrix<T>::init_ccs(matrix);
+
+    matrix_state = linalg::runtime_format(format);
+    rows = static_cast<int>(_coo.n_rows);
+    cols = static_cast<int>(_coo.n_cols);
+    ld = linalg::detail::padded_leading_dim<T>(cols);
+
+    // Sparse formats are built from the triplets directly, the dense buffer
+    // is only allocated when the dense representation is requested.
+    // The compressed conversions check the triplet bounds themselves
+    if (matrix_state == linalg::Format::CRS) {
+        crs_matrix = _coo.to_crs();
     }
-    else if (sparse == "COO") {
-        coo_matrix = linalg::Matrix<T>::init_coo(matrix);
+    else if (matrix_state == linalg::Format::CCS) {
+        ccs_matrix = _coo.to_ccs();
     }
-    else if (sparse == "def");
-    else if (sparse == "all") {
-        crs_matrix = linalg::Matrix<T>::init_crs(matrix);
-        ccs_matrix = linalg::Matrix<T>::init_ccs(matrix);
-        coo_matrix = linalg::Matrix<T>::init_coo(matrix);
+    else if (matrix_state == linalg::Format::COO) {
+        linalg::detail::check_triplet_bounds(rows, cols, _coo.row_indexes, _coo.col_indexes);
+        coo_matrix = _coo;
     }
+    else {
+        linalg::detail::check_triplet_bounds(rows, cols, _coo.row_indexes, _coo.col_indexes);
+        reshape_dense(rows, cols);
 
-    update_rows();
-    update_cols();
+        for (std::size_t idx = 0; idx < _coo.values.size(); ++idx) {
+            matrix[_coo.row_indexes[idx] * ld + _coo.col_indexes[idx]] += _coo.values[idx];
+        }
+    }
 
-    logger->debug("Matrix dimensionality updated to ({}, {})", rows, cols);
-    logger->info("Matrix created. Dimensionality ({}, {})", rows, cols);
+    LINALG_LOG_INFO("Matrix created. Dimensionality ({}, {})", rows, cols);
+}
 
-    logger->flush();
+template<typename T>
+linalg::Matrix<T>::Matrix(const linalg::Matrix<T> &_oth)
+    : matrix(_oth.matrix), ld(_oth.ld),
+      crs_matrix(_oth.crs_matrix), ccs_matrix(_oth.ccs_matrix), coo_matrix(_oth.coo_matrix),
+      matrix_state(_oth.matrix_state), version(_oth.version), cached(_oth.cached),
+      rows(_oth.rows), cols(_oth.cols) {
 }
 
 template<typename T>
-linalg::Matrix<T>::Matrix(const linalg::Matrix<T> &_oth) {
-    auto logger = spdlog::get("global_logger");
+linalg::Matrix<T>::Matrix(linalg::Matrix<T> &&_oth) noexcept
+    : matrix(std::move(_oth.matrix)), ld(_oth.ld),
+      crs_matrix(std::move(_oth.crs_matrix)), ccs_matrix(std::move(_oth.ccs_matrix)),
+      coo_matrix(std::move(_oth.coo_matrix)),
+      matrix_state(_oth.matrix_state), version(_oth.version), cached(_oth.cached),
+      rows(_oth.rows), cols(_oth.cols) {
+    _oth.rows = 0;
+    _oth.cols = 0;
+}
 
+template<typename T>
+template<linalg::expr::Node E>
+linalg::Matrix<T>::Matrix(const E& _expr) : ld(0), matrix_state(linalg::Format::Dense), rows(0), cols(0) {
+    assign_expression(_expr);
 }
 
 template<typename T>
 linalg::Matrix<T>::~Matrix() {
-    auto logger = spdlog::get("global_logger");
+}
+
+template<typename T>
+linalg::Matrix<T>& linalg::Matrix<T>::operator=(const linalg::Matrix<T> &_oth) {
+    if (this == &_oth) return *this;
+
+    matrix = _oth.matrix;
+    ld = _oth.ld;
+    crs_matrix = _oth.crs_matrix;
+    ccs_matrix = _oth.ccs_matrix;
+    coo_matrix = _oth.coo_matrix;
+    matrix_state = _oth.matrix_state;
+    version = _oth.version;
+    cached = _oth.cached;
+    rows = _oth.rows;
+    cols = _oth.cols;
+
+    return *this;
+}
+
+template<typename T>
+linalg::Matrix<T>& linalg::Matrix<T>::operator=(linalg::Matrix<T> &&_oth) noexcept {
+    if (this == &_oth) return *this;
+
+    matrix = std::move(_oth.matrix);
+    ld = _oth.ld;
+    crs_matrix = std::move(_oth.crs_matrix);
+    ccs_matrix = std::move(_oth.ccs_matrix);
+    coo_matrix = std::move(_oth.coo_matrix);
+    matrix_state = _oth.matrix_state;
+    version = _oth.version;
+    cached = _oth.cached;
+    rows = _oth.rows;
+    cols = _oth.cols;
+
+    _oth.rows = 0;
+    _oth.cols = 0;
+
+    return *this;
+}
+
+template<typename T>
+template<linalg::expr::Node E>
+linalg::Matrix<T>& linalg::Matrix<T>::operator=(const E& _expr) {
+    assign_expression(_expr);
+    return *this;
+}
+
+template<typename T>
+void linalg::Matrix<T>::reshape_dense(int _rows, int _cols) {
+    rows = _rows;
+    cols = _cols;
+    ld = linalg::detail::padded_leading_dim<T>(cols);
+
+    matrix.assign(static_cast<std::size_t>(rows) * ld, static_cast<T>(0));
+
+    linalg::metrics::add(linalg::metrics::Counter::bytes_allocated, matrix.size() * sizeof(T));
+}
+
+template<typename T>
+void linalg::Matrix<T>::load_format(const std::vector<std::vector<T>>& _matrix) {
+    // Only the authoritative format is built; "all" keeps the dense buffer
+    // and materializes the sparse formats on first use
+    if (matrix_state == linalg::Format::Dense || matrix_state == linalg::Format::All) {
+        load_dense(_matrix);
+        return;
+    }
+
+    rows = _matrix.size();
+    cols = _matrix.empty() ? 0 : _matrix[0].size();
+    ld = linalg::detail::padded_leading_dim<T>(cols);
+
+    if (matrix_state == linalg::Format::CRS)      crs_matrix = linalg::Matrix<T>::init_crs(_matrix);
+    else if (matrix_state == linalg::Format::CCS) ccs_matrix = linalg::Matrix<T>::init_ccs(_matrix);
+    else if (matrix_state == linalg::Format::COO) coo_matrix = linalg::Matrix<T>::init_coo(_matrix);
+}
+
+template<typename T>
+void linalg::Matrix<T>::load_dense(const std::vector<std::vector<T>>& _matrix) {
+    reshape_dense(_matrix.size(), _matrix.empty() ? 0 : _matrix[0].size());
+
+    for (std::size_t i = 0; i < _matrix.size(); ++i) {
+        std::copy(_matrix[i].begin(), _matrix[i].end(), matrix.begin() + i * ld);
+    }
 }
 
 #pragma endregion
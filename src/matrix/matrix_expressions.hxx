@@ -0,0 +1,160 @@
+#pragma once
+
+#ifndef MATRIX_EXPRESSIONS_HXX
+#define MATRIX_EXPRESSIONS_HXX
+
+#include "../../include/linalg/matrix.hxx"
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#pragma region Matrix Expressions
+
+template<typename T>
+linalg::expr::MatrixLeaf<T>::MatrixLeaf(const linalg::Matrix<T>& _matrix)
+    : n_rows(_matrix.rows), n_cols(_matrix.cols) {
+    // Sparse formats are read through their (cached) CRS rows
+    if (_matrix.matrix_state != linalg::Format::Dense && _matrix.matrix_state != linalg::Format::All) {
+        const auto& crs = _matrix.crs();
+
+        if (!crs.row_pointers.empty()) {
+            sparse = true;
+            ptr = crs.row_pointers.data();
+            idx = crs.col_indexes.data();
+            vals = crs.values.data();
+            return;
+        }
+    }
+
+    _matrix.sync_dense();
+    data = _matrix.matrix.data();
+    ld = _matrix.ld;
+}
+
+namespace linalg::detail {
+
+    // Rows handed to one task of the thread pool
+    inline constexpr std::size_t EXPRESSION_ROWS_PER_TASK = 64;
+
+}
+
+template<typename T>
+template<linalg::expr::Node E>
+void linalg::Matrix<T>::assign_expression(const E& _expr) {
+    static_assert(std::is_same_v<typename E::value_type, T>,
+                  "Expression element type differs from the destination matrix");
+
+    const std::size_t n_rows = _expr.rows();
+    const std::size_t n_cols = _expr.cols();
+    constexpr std::size_t rows_per_task = linalg::detail::EXPRESSION_ROWS_PER_TASK;
+    const std::size_t tasks = (n_rows + rows_per_task - 1) / rows_per_task;
+
+    // Sparse operands only: merge the row patterns once and emit CRS directly
+    if constexpr (E::sparse_closed) {
+        if (_expr.all_sparse()) {
+            struct Part {
+                std::vector<long long>      col_indexes;
+                std::vector<T>              values;
+                std::vector<long long>      row_nnz;
+            };
+            std::vector<Part> parts(tasks);
+
+            linalg::parallel::parallel_for(tasks, [&](std::size_t task, std::size_t) {
+                E local = _expr;
+                Part& part = parts[task];
+                std::size_t end = std::min(n_rows, (task + 1) * rows_per_task);
+
+                for (std::size_t i = task * rows_per_task; i < end; ++i) {
+                    local.begin_row(i);
+                    long long count = 0;
+
+                    for (long long j = local.seek(0); j != linalg::expr::END; j = local.seek(j + 1)) {
+                        T value = local.at(i, j);
+                        if (value == static_cast<T>(0)) continue; // Cancelled out, keep the pattern tight
+
+                        part.col_indexes.push_back(j);
+                        part.values.push_back(value);
+                        ++count;
+                    }
+                    part.row_nnz.push_back(count);
+                }
+            });
+
+            CRS result;
+            result.row_pointers.reserve(n_rows + 1);
+            result.row_pointers.push_back(0);
+
+            for (const Part& part : parts) {
+                for (long long count : part.row_nnz) {
+                    result.row_pointers.push_back(result.row_pointers.back() + count);
+                }
+                result.col_indexes.insert(result.col_indexes.end(), part.col_indexes.begin(), part.col_indexes.end());
+                result.values.insert(result.values.end(), part.values.begin(), part.values.end());
+            }
+
+            linalg::metrics::add(linalg::metrics::Counter::nnz_touched, result.values.size());
+            linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                                 result.values.size() * (sizeof(T) + sizeof(long long)) +
+                                 result.row_pointers.size() * sizeof(long long));
+
+            crs_matrix = std::move(result);
+            matrix_state = linalg::Format::CRS;
+            rows = n_rows;
+            cols = n_cols;
+            ld = linalg::detail::padded_leading_dim<T>(n_cols);
+            invalidate_caches();
+            return;
+        }
+    }
+
+    // Dense result. Elementwise evaluation reads (i, j) before writing it, so a
+    // dense destination of the right size is overwritten in place even when it
+    // is one of the operands, and no buffer is allocated at all.
+    const bool in_place = matrix_state == linalg::Format::Dense &&
+                          static_cast<std::size_t>(rows) == n_rows &&
+                          static_cast<std::size_t>(cols) == n_cols &&
+                          matrix.size() == n_rows * ld;
+
+    DenseBuffer fresh;
+    std::size_t dst_ld = ld;
+
+    if (!in_place) {
+        dst_ld = linalg::detail::padded_leading_dim<T>(n_cols);
+        fresh.assign(n_rows * dst_ld, static_cast<T>(0));
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated, fresh.size() * sizeof(T));
+    }
+
+    T* dst = in_place ? matrix.data() : fresh.data();
+    const bool mixed = _expr.any_sparse();
+
+    linalg::parallel::parallel_for(tasks, [&](std::size_t task, std::size_t) {
+        E local = _expr;
+        std::size_t end = std::min(n_rows, (task + 1) * rows_per_task);
+
+        for (std::size_t i = task * rows_per_task; i < end; ++i) {
+            T* row = dst + i * dst_ld;
+
+            if (!mixed) {
+                for (std::size_t j = 0; j < n_cols; ++j) row[j] = local.at_dense(i, j);
+                continue;
+            }
+
+            local.begin_row(i);
+            for (std::size_t j = 0; j < n_cols; ++j) row[j] = local.at(i, j);
+        }
+    });
+
+    if (!in_place) {
+        matrix = std::move(fresh);
+        ld = dst_ld;
+        rows = n_rows;
+        cols = n_cols;
+    }
+
+    matrix_state = linalg::Format::Dense;
+    invalidate_caches();
+}
+
+#pragma endregion
+
+#endif // MATRIX_EXPRESSIONS_HXX
@@ -0,0 +1,437 @@
+#pragma once
+
+#ifndef MATRIX_FORMATS_HXX
+#define MATRIX_FORMATS_HXX
+
+#include "../../include/linalg/matrix.hxx"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#pragma region Compile-time Format Matrix
+
+namespace linalg::detail {
+
+    // Throws when `value` does not fit the index type `I`
+    template<typename I>
+    void check_index_range(long long value, const char* what) {
+        if (value <= static_cast<long long>(std::numeric_limits<I>::max())) return;
+
+        std::ostringstream oss;
+        oss << what << " " << value << " exceeds the range of a " << sizeof(I) * 8 << "-bit index.";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::out_of_range(oss.str());
+    }
+
+    // Copies a compressed layout into one with another index type
+    template<typename T, typename J, typename I>
+    void copy_compressed(const SparseArray<J>& ptr, const SparseArray<J>& idx, const SparseArray<T>& vals,
+                         SparseArray<I>& out_ptr, SparseArray<I>& out_idx, SparseArray<T>& out_vals) {
+        out_ptr.resize(ptr.size());
+        out_idx.resize(idx.size());
+        std::transform(ptr.begin(), ptr.end(), out_ptr.begin(), [](J k) { return static_cast<I>(k); });
+        std::transform(idx.begin(), idx.end(), out_idx.begin(), [](J k) { return static_cast<I>(k); });
+        out_vals = vals;
+    }
+
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix() : Matrix(0, 0) {
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix(I _rows, I _cols) : rows(_rows), cols(_cols) {
+    if (_rows < 0 || _cols < 0) {
+        LINALG_LOG_ERROR("Negative matrix dimensionality ({}, {})", _rows, _cols);
+        throw std::logic_error("Negative matrix dimensionality.");
+    }
+
+    if constexpr (F == linalg::Format::Dense) {
+        data.ld = linalg::detail::padded_leading_dim<T>(cols);
+        data.data.assign(static_cast<std::size_t>(rows) * data.ld, static_cast<T>(0));
+
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated, data.data.size() * sizeof(T));
+    }
+    else if constexpr (compressed) {
+        data.pointers.assign((F == linalg::Format::CRS ? rows : cols) + 1, 0);
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix(const std::vector<std::vector<T>>& _oth) {
+    std::size_t row_weight = _oth.empty() ? 0 : _oth[0].size();
+
+    for (const auto& row : _oth) {
+        if (row.size() != row_weight) {
+            std::ostringstream oss;
+            oss << "Matrix is not formed: expected dim (" << _oth.size() << ", " << row_weight
+                << "). Found: (" << _oth.size() << ", " << row.size() << ").";
+
+            LINALG_LOG_ERROR(oss.str());
+            throw std::logic_error(oss.str());
+        }
+    }
+
+    if (_oth.empty()) {
+        *this = Matrix(0, 0);
+        return;
+    }
+
+    if constexpr (F == linalg::Format::Dense) {
+        *this = Matrix(static_cast<I>(_oth.size()), static_cast<I>(row_weight));
+
+        for (std::size_t i = 0; i < _oth.size(); ++i) {
+            std::copy(_oth[i].begin(), _oth[i].end(), data.data.begin() + i * data.ld);
+        }
+    }
+    else {
+        auto triplets = linalg::Matrix<T>::init_coo(_oth);
+        triplets.n_rows = _oth.size();
+        triplets.n_cols = row_weight;
+
+        load_triplets(triplets);
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix(std::initializer_list<std::initializer_list<T>> init_matrix)
+    : Matrix(std::vector<std::vector<T>>(init_matrix.begin(), init_matrix.end())) {
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix(const typename linalg::Matrix<T>::COO& _coo) {
+    load_triplets(_coo);
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T, F, I>::Matrix(const linalg::Matrix<T>& _oth) {
+    linalg::detail::check_index_range<I>(_oth.rows, "Row count");
+    linalg::detail::check_index_range<I>(_oth.cols, "Column count");
+
+    // Compressed layouts copy the (cached) arrays of the same layout, no sort
+    if constexpr (F == linalg::Format::CRS) {
+        const auto& source = _oth.crs();
+
+        if (!source.row_pointers.empty()) {
+            linalg::detail::check_index_range<I>(source.values.size(), "Nonzero count");
+            linalg::detail::copy_compressed(source.row_pointers, source.col_indexes, source.values,
+                                            data.pointers, data.indexes, data.values);
+            rows = _oth.rows;
+            cols = _oth.cols;
+            return;
+        }
+    }
+    else if constexpr (F == linalg::Format::CCS) {
+        const auto& source = _oth.ccs();
+
+        if (!source.col_pointers.empty()) {
+            linalg::detail::check_index_range<I>(source.values.size(), "Nonzero count");
+            linalg::detail::copy_compressed(source.col_pointers, source.row_indexes, source.values,
+                                            data.pointers, data.indexes, data.values);
+            rows = _oth.rows;
+            cols = _oth.cols;
+            return;
+        }
+    }
+    else if constexpr (F == linalg::Format::Dense) {
+        *this = Matrix(static_cast<I>(_oth.rows), static_cast<I>(_oth.cols));
+        _oth.sync_dense();
+
+        for (int i = 0; i < _oth.rows; ++i) {
+            std::copy(_oth.matrix.begin() + i * _oth.ld, _oth.matrix.begin() + i * _oth.ld + _oth.cols,
+                      data.data.begin() + i * data.ld);
+        }
+        return;
+    }
+
+    load_triplets(_oth.collect_triplets());
+}
+
+template<typename T, linalg::Format F, typename I>
+void linalg::Matrix<T, F, I>::load_triplets(const typename linalg::Matrix<T>::COO& _coo) {
+    linalg::detail::check_index_range<I>(_coo.n_rows, "Row count");
+    linalg::detail::check_index_range<I>(_coo.n_cols, "Column count");
+    linalg::detail::check_index_range<I>(_coo.values.size(), "Nonzero count");
+
+    if constexpr (F == linalg::Format::Dense) {
+        linalg::detail::check_triplet_bounds(_coo.n_rows, _coo.n_cols, _coo.row_indexes, _coo.col_indexes);
+        *this = Matrix(static_cast<I>(_coo.n_rows), static_cast<I>(_coo.n_cols));
+
+        for (std::size_t idx = 0; idx < _coo.values.size(); ++idx) {
+            data.data[_coo.row_indexes[idx] * data.ld + _coo.col_indexes[idx]] += _coo.values[idx];
+        }
+    }
+    else if constexpr (F == linalg::Format::CRS) {
+        rows = static_cast<I>(_coo.n_rows);
+        cols = static_cast<I>(_coo.n_cols);
+
+        linalg::detail::compress_triplets(rows, cols, _coo.row_indexes, _coo.col_indexes, _coo.values, true,
+                                          data.pointers, data.indexes, data.values);
+    }
+    else if constexpr (F == linalg::Format::CCS) {
+        rows = static_cast<I>(_coo.n_rows);
+        cols = static_cast<I>(_coo.n_cols);
+
+        linalg::detail::compress_triplets(cols, rows, _coo.col_indexes, _coo.row_indexes, _coo.values, true,
+                                          data.pointers, data.indexes, data.values);
+    }
+    else {
+        linalg::detail::check_triplet_bounds(_coo.n_rows, _coo.n_cols, _coo.row_indexes, _coo.col_indexes);
+        auto narrow = [](long long k) { return static_cast<I>(k); };
+
+        rows = static_cast<I>(_coo.n_rows);
+        cols = static_cast<I>(_coo.n_cols);
+
+        data.row_indexes.resize(_coo.row_indexes.size());
+        data.col_indexes.resize(_coo.col_indexes.size());
+        std::transform(_coo.row_indexes.begin(), _coo.row_indexes.end(), data.row_indexes.begin(), narrow);
+        std::transform(_coo.col_indexes.begin(), _coo.col_indexes.end(), data.col_indexes.begin(), narrow);
+        data.values = _coo.values;
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+typename linalg::Matrix<T>::COO linalg::Matrix<T, F, I>::collect_triplets() const {
+    typename linalg::Matrix<T>::COO triplets;
+    triplets.reserve(nnz());
+
+    if constexpr (F == linalg::Format::Dense) {
+        for (I i = 0; i < rows; ++i) {
+            for (I j = 0; j < cols; ++j) {
+                T value = data.data[i * data.ld + j];
+                if (value != 0) triplets.add(i, j, value);
+            }
+        }
+    }
+    else if constexpr (compressed) {
+        I n_outer = F == linalg::Format::CRS ? rows : cols;
+
+        for (I outer = 0; outer < n_outer; ++outer) {
+            for (I idx = data.pointers[outer]; idx < data.pointers[outer + 1]; ++idx) {
+                if constexpr (F == linalg::Format::CRS) triplets.add(outer, data.indexes[idx], data.values[idx]);
+                else                                    triplets.add(data.indexes[idx], outer, data.values[idx]);
+            }
+        }
+    }
+    else {
+        for (std::size_t idx = 0; idx < data.values.size(); ++idx) {
+            triplets.add(data.row_indexes[idx], data.col_indexes[idx], data.values[idx]);
+        }
+    }
+
+    triplets.n_rows = rows;
+    triplets.n_cols = cols;
+
+    return triplets;
+}
+
+template<typename T, linalg::Format F, typename I>
+linalg::Matrix<T> linalg::Matrix<T, F, I>::to_dynamic() const {
+    if constexpr (compressed) {
+        linalg::Matrix<T> result = linalg::Matrix<T>::sparse_shell(rows, cols, F);
+
+        if constexpr (F == linalg::Format::CRS) {
+            linalg::detail::copy_compressed(data.pointers, data.indexes, data.values, result.crs_matrix.row_pointers,
+                                            result.crs_matrix.col_indexes, result.crs_matrix.values);
+        }
+        else {
+            linalg::detail::copy_compressed(data.pointers, data.indexes, data.values, result.ccs_matrix.col_pointers,
+                                            result.ccs_matrix.row_indexes, result.ccs_matrix.values);
+        }
+
+        return result;
+    }
+    else {
+        return linalg::Matrix<T>(collect_triplets(), F);
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+void linalg::Matrix<T, F, I>::check_bounds(I i, I j) const {
+    if (i >= 0 && i < rows && j >= 0 && j < cols) return;
+
+    LINALG_LOG_ERROR("Index ({}, {}) out of bounds for ({}, {})", i, j, rows, cols);
+    throw std::out_of_range("Matrix index out of bounds.");
+}
+
+template<typename T, linalg::Format F, typename I>
+std::size_t linalg::Matrix<T, F, I>::nnz() const {
+    if constexpr (F == linalg::Format::Dense) return static_cast<std::size_t>(rows) * cols;
+    else return data.values.size();
+}
+
+template<typename T, linalg::Format F, typename I>
+T linalg::Matrix<T, F, I>::get(I i, I j) const {
+    check_bounds(i, j);
+
+    if constexpr (F == linalg::Format::Dense) {
+        return data.data[i * data.ld + j];
+    }
+    else if constexpr (compressed) {
+        I outer = F == linalg::Format::CRS ? i : j;
+        I inner = F == linalg::Format::CRS ? j : i;
+
+        // Indexes within a slice are sorted
+        const I* first = data.indexes.data() + data.pointers[outer];
+        const I* last = data.indexes.data() + data.pointers[outer + 1];
+        const I* pos = std::lower_bound(first, last, inner);
+
+        return pos != last && *pos == inner ? data.values[pos - data.indexes.data()] : static_cast<T>(0);
+    }
+    else {
+        // Triplets sharing a position are summed
+        T sum = static_cast<T>(0);
+        for (std::size_t idx = 0; idx < data.values.size(); ++idx) {
+            if (data.row_indexes[idx] == i && data.col_indexes[idx] == j) sum += data.values[idx];
+        }
+        return sum;
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+void linalg::Matrix<T, F, I>::set(I i, I j, const T& _val) {
+    check_bounds(i, j);
+
+    if constexpr (F == linalg::Format::Dense) {
+        data.data[i * data.ld + j] = _val;
+    }
+    else if constexpr (compressed) {
+        I outer = F == linalg::Format::CRS ? i : j;
+        I inner = F == linalg::Format::CRS ? j : i;
+
+        const I* first = data.indexes.data() + data.pointers[outer];
+        const I* last = data.indexes.data() + data.pointers[outer + 1];
+        std::size_t pos = std::lower_bound(first, last, inner) - data.indexes.data();
+        bool found = data.indexes.data() + pos != last && data.indexes[pos] == inner;
+
+        if (found && _val != 0) {
+            data.values[pos] = _val;
+            return;
+        }
+        if (!found && _val == 0) return;
+
+        // Structural change: every later slice shifts by one entry
+        I shift = found ? -1 : 1;
+
+        if (found) {
+            data.indexes.erase(data.indexes.begin() + pos);
+            data.values.erase(data.values.begin() + pos);
+            linalg::metrics::add(linalg::metrics::Counter::erases);
+        }
+        else {
+            data.indexes.insert(data.indexes.begin() + pos, inner);
+            data.values.insert(data.values.begin() + pos, _val);
+            linalg::metrics::add(linalg::metrics::Counter::inserts);
+        }
+
+        for (std::size_t k = outer + 1; k < data.pointers.size(); ++k) data.pointers[k] += shift;
+    }
+    else {
+        bool found = false;
+
+        // The first triplet at (i, j) takes the value, later duplicates are zeroed
+        for (std::size_t idx = 0; idx < data.values.size(); ++idx) {
+            if (data.row_indexes[idx] == i && data.col_indexes[idx] == j) {
+                data.values[idx] = found ? static_cast<T>(0) : _val;
+                found = true;
+            }
+        }
+
+        if (!found && _val != 0) {
+            data.row_indexes.push_back(i);
+            data.col_indexes.push_back(j);
+            data.values.push_back(_val);
+            linalg::metrics::add(linalg::metrics::Counter::inserts);
+        }
+    }
+}
+
+template<typename T, linalg::Format F, typename I>
+std::vector<T> linalg::Matrix<T, F, I>::operator*(const std::vector<T>& x) const {
+    if (x.size() != static_cast<std::size_t>(cols)) {
+        std::ostringstream oss;
+        oss << "Matrix-vector dimension mismatch: (" << rows << ", " << cols << ") * (" << x.size() << ").";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
+
+    std::vector<T> y(rows, static_cast<T>(0));
+
+    if constexpr (F == linalg::Format::Dense) {
+        linalg::kernels::gemv<T>(rows, cols, data.data.data(), data.ld, x.data(), y.data());
+    }
+    else if constexpr (F == linalg::Format::CRS) {
+        linalg::kernels::spmv<T, I>(rows, data.pointers.data(), data.indexes.data(), data.values.data(),
+                                    x.data(), y.data());
+    }
+    else if constexpr (F == linalg::Format::CCS) {
+        // A * x over columns is a scatter; there is no race-free split, so run it serially
+        for (I j = 0; j < cols; ++j) {
+            for (I idx = data.pointers[j]; idx < data.pointers[j + 1]; ++idx) {
+                y[data.indexes[idx]] += data.values[idx] * x[j];
+            }
+        }
+    }
+    else {
+        for (std::size_t idx = 0; idx < data.values.size(); ++idx) {
+            y[data.row_indexes[idx]] += data.values[idx] * x[data.col_indexes[idx]];
+        }
+    }
+
+    return y;
+}
+
+template<typename T, linalg::Format F, typename I>
+std::vector<T> linalg::Matrix<T, F, I>::transpose_multiply(const std::vector<T>& x) const {
+    if (x.size() != static_cast<std::size_t>(rows)) {
+        std::ostringstream oss;
+        oss << "Transposed matrix-vector dimension mismatch: (" << cols << ", " << rows
+            << ") * (" << x.size() << ").";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
+
+    std::vector<T> y(cols, static_cast<T>(0));
+
+    if constexpr (F == linalg::Format::Dense) {
+        for (I i = 0; i < rows; ++i) {
+            const T* row = data.data.data() + i * data.ld;
+            for (I j = 0; j < cols; ++j) y[j] += row[j] * x[i];
+        }
+    }
+    else if constexpr (F == linalg::Format::CCS) {
+        linalg::kernels::spmv<T, I>(cols, data.pointers.data(), data.indexes.data(), data.values.data(),
+                                    x.data(), y.data());
+    }
+    else if constexpr (F == linalg::Format::CRS) {
+        // A^T * x over rows is a scatter; there is no race-free split, so run it serially
+        for (I i = 0; i < rows; ++i) {
+            for (I idx = data.pointers[i]; idx < data.pointers[i + 1]; ++idx) {
+                y[data.indexes[idx]] += data.values[idx] * x[i];
+            }
+        }
+    }
+    else {
+        for (std::size_t idx = 0; idx < data.values.size(); ++idx) {
+            y[data.col_indexes[idx]] += data.values[idx] * x[data.row_indexes[idx]];
+        }
+    }
+
+    return y;
+}
+
+// Converting constructor of the runtime matrix, defined here next to its source type
+template<typename T>
+template<linalg::Format F, typename I>
+linalg::Matrix<T>::Matrix(const linalg::Matrix<T, F, I>& _oth) : Matrix(_oth.to_dynamic()) {
+}
+
+#pragma endregion
+
+#endif // MATRIX_FORMATS_HXX
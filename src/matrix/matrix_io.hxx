@@ -0,0 +1,149 @@
+#pragma once
+
+#ifndef MATRIX_IO_HXX
+#define MATRIX_IO_HXX
+
+#include "../../include/linalg/matrix.hxx"
+#include "../io/binary_format.hxx"
+#include "../io/matrix_market.hxx"
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#pragma region Matrix Files
+
+template<typename T>
+linalg::Matrix<T> linalg::Matrix<T>::sparse_shell(long long _rows, long long _cols, linalg::Format state) {
+    if (_rows > INT_MAX || _cols > INT_MAX) {
+        LINALG_LOG_ERROR("Matrix dimensionality ({}, {}) exceeds the supported range", _rows, _cols);
+        throw std::out_of_range("Matrix dimensionality exceeds the supported range.");
+    }
+
+    linalg::Matrix<T> result;
+    result.matrix = DenseBuffer();
+    result.rows = static_cast<int>(_rows);
+    result.cols = static_cast<int>(_cols);
+    result.ld = linalg::detail::padded_leading_dim<T>(result.cols);
+    result.matrix_state = state;
+
+    return result;
+}
+
+template<typename T>
+typename linalg::Matrix<T>::COO linalg::Matrix<T>::collect_triplets() const {
+    COO triplets;
+    linalg::Format source = authority();
+
+    if (source == linalg::Format::COO) {
+        triplets = coo_matrix;
+    }
+    else if (source == linalg::Format::CRS && !crs_matrix.row_pointers.empty()) {
+        const CRS& crs = crs_matrix;
+        triplets.reserve(crs.values.size());
+
+        for (int i = 0; i < rows; ++i) {
+            for (long long idx = crs.row_pointers[i]; idx < crs.row_pointers[i + 1]; ++idx) {
+                triplets.add(i, crs.col_indexes[idx], crs.values[idx]);
+            }
+        }
+    }
+    else if (source == linalg::Format::CCS && !ccs_matrix.col_pointers.empty()) {
+        const CCS& ccs = ccs_matrix;
+        triplets.reserve(ccs.values.size());
+
+        for (int j = 0; j < cols; ++j) {
+            for (long long idx = ccs.col_pointers[j]; idx < ccs.col_pointers[j + 1]; ++idx) {
+                triplets.add(ccs.row_indexes[idx], j, ccs.values[idx]);
+            }
+        }
+    }
+    else {
+        sync_dense();
+
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                if (matrix[i * ld + j] != 0) triplets.add(i, j, matrix[i * ld + j]);
+            }
+        }
+    }
+
+    triplets.n_rows = rows;
+    triplets.n_cols = cols;
+
+    return triplets;
+}
+
+template<typename T>
+void linalg::Matrix<T>::save_binary(const std::string& path, const std::string& sparse) const {
+    linalg::Format layout = linalg::parse_format(sparse);
+
+    if (layout == linalg::Format::CRS) {
+        const CRS& source = crs();
+
+        linalg::io::write_binary<T, long long>(
+            path, linalg::io::BinaryLayout::CRS, rows, cols,
+            source.row_pointers.data(), source.col_indexes.data(), source.values.data()
+        );
+    }
+    else if (layout == linalg::Format::CCS) {
+        const CCS& source = ccs();
+
+        linalg::io::write_binary<T, long long>(
+            path, linalg::io::BinaryLayout::CCS, rows, cols,
+            source.col_pointers.data(), source.row_indexes.data(), source.values.data()
+        );
+    }
+    else {
+        LINALG_LOG_ERROR("Binary layout must be CRS or CCS, got `{}`", sparse);
+        throw std::logic_error("Binary layout must be CRS or CCS, got `" + sparse + "`.");
+    }
+}
+
+template<typename T>
+linalg::Matrix<T> linalg::Matrix<T>::open_binary(const std::string& path, bool validate) {
+    auto view = linalg::io::map_binary<T, long long>(path, validate);
+    bool by_rows = view.header.layout == static_cast<std::uint32_t>(linalg::io::BinaryLayout::CRS);
+
+    linalg::Matrix<T> result = sparse_shell(view.header.rows, view.header.cols,
+                                            by_rows ? linalg::Format::CRS : linalg::Format::CCS);
+
+    using linalg::detail::SparseArray;
+    auto pointers = SparseArray<long long>::borrow(view.pointers, view.n_outer + 1, view.file);
+    auto indexes = SparseArray<long long>::borrow(view.indexes, view.header.nnz, view.file);
+    auto values = SparseArray<T>::borrow(view.values, view.header.nnz, view.file);
+
+    if (by_rows) {
+        result.crs_matrix.row_pointers = std::move(pointers);
+        result.crs_matrix.col_indexes = std::move(indexes);
+        result.crs_matrix.values = std::move(values);
+    }
+    else {
+        result.ccs_matrix.col_pointers = std::move(pointers);
+        result.ccs_matrix.row_indexes = std::move(indexes);
+        result.ccs_matrix.values = std::move(values);
+    }
+
+    return result;
+}
+
+template<typename T>
+linalg::Matrix<T> linalg::Matrix<T>::read_matrix_market(const std::string& path, const std::string& sparse) {
+    linalg::Format format = linalg::parse_format(sparse);
+
+    COO triplets;
+    linalg::io::read_matrix_market<T>(path, triplets);
+
+    // The triplets are the result itself, no copy
+    if (format == linalg::Format::COO) {
+        linalg::Matrix<T> result = sparse_shell(triplets.n_rows, triplets.n_cols, linalg::Format::COO);
+        result.coo_matrix = std::move(triplets);
+        return result;
+    }
+
+    return linalg::Matrix<T>(triplets, format);
+}
+
+#pragma endregion
+
+#endif // MATRIX_IO_HXX
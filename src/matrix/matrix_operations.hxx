@@ -4,45 +4,84 @@
 #define MATRIX_OPERATIONS_HXX
 
 #include "../../include/linalg/matrix.hxx"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
 
 #pragma region Matrix Operations and Methods
 
 template<typename T>
-T& linalg::Matrix<T>::get(int i, int j) {
-    auto logger = spdlog::get("global_logger");
-
-    if (matrix_state == "def" || matrix_state == "all") return matrix[i][j];
-    else if (matrix_state == "CRS")                     return crs_matrix(i, j);
-    else if (matrix_state == "CCS")                     return ccs_matrix(i, j);
-    else if (matrix_state == "COO")                     return coo_matrix(i, j);
-    
-    static T def = static_cast<T>(0);
-    return def;
+void linalg::Matrix<T>::check_bounds(int i, int j) const {
+    if (i >= 0 && i < rows && j >= 0 && j < cols) return;
+
+    LINALG_LOG_ERROR("Index ({}, {}) out of bounds for ({}, {})", i, j, rows, cols);
+    throw std::out_of_range("Matrix index out of bounds.");
+}
+
+template<typename T>
+T linalg::Matrix<T>::get(int i, int j) const {
+    check_bounds(i, j);
+
+    // Read through const views: leaves the caches and any mapped arrays alone
+    linalg::Format source = authority();
+    if (source == linalg::Format::Dense)    return matrix[i * ld + j];
+    else if (source == linalg::Format::CRS) return std::as_const(crs_matrix)(i, j);
+    else if (source == linalg::Format::CCS) return std::as_const(ccs_matrix)(i, j);
+    else if (source == linalg::Format::COO) return std::as_const(coo_matrix)(i, j);
+
+    return static_cast<T>(0);
 }
 
 template<typename T>
 void linalg::Matrix<T>::set(int i, int j, const T& _val) {
-    auto logger = spdlog::get("global_logger");
-    logger->debug("Main matrix function: Starting setting value {}, sparse mode: {}", _val, matrix_state);
-
-    if (matrix_state == "def") matrix[i][j] = _val;
-    else if (matrix_state == "CRS") crs_matrix.set(i, j, _val);
-    else if (matrix_state == "CCS") ccs_matrix.set(i, j, _val);
-    else if (matrix_state == "COO") coo_matrix.set(i, j, _val);
-    else if (matrix_state == "all") 
-    {
-                                    crs_matrix.set(i, j, _val);
-                                    ccs_matrix.set(i, j, _val);
-                                    coo_matrix.set(i, j, _val);
-                                    matrix[i][j] = _val;
-    }
+    LINALG_LOG_DEBUG("Main matrix function: Starting setting value {}, sparse mode: {}", _val, linalg::format_name(matrix_state));
+
+    // The formats only know their outer extent; an entry outside the matrix
+    // would be carried into every cached format and product
+    check_bounds(i, j);
+
+    // Only the authoritative format is written, the others are rebuilt on demand
+    linalg::Format source = authority();
+    if (source == linalg::Format::Dense)    matrix[i * ld + j] = _val;
+    else if (source == linalg::Format::CRS) crs_matrix.set(i, j, _val);
+    else if (source == linalg::Format::CCS) ccs_matrix.set(i, j, _val);
+    else if (source == linalg::Format::COO) coo_matrix.set(i, j, _val);
+
+    invalidate_caches();
 }
 
 template<typename T>
-std::string linalg::Matrix<T>::print() {
-    auto logger = spdlog::get("global_logger");
+std::string linalg::Matrix<T>::print() const {
+    return crs().print();
+}
+
+template<typename T>
+std::vector<T> linalg::Matrix<T>::transpose_multiply(const std::vector<T>& x) const {
+    if (x.size() != static_cast<std::size_t>(rows)) {
+        std::ostringstream oss;
+        oss << "Transposed matrix-vector dimension mismatch: (" << cols << ", " << rows
+            << ") * (" << x.size() << ").";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
+
+    // Column j of A is row j of A^T: gather over the (cached) CCS arrays
+    if (matrix_state != linalg::Format::Dense) {
+        return ccs().transpose_multiply(x);
+    }
+
+    std::vector<T> y(cols, static_cast<T>(0));
+
+    sync_dense();
+
+    for (int i = 0; i < rows; ++i) {
+        const T* row = matrix.data() + i * ld;
+        for (int j = 0; j < cols; ++j) y[j] += row[j] * x[i];
+    }
 
-    return crs_matrix.print();
+    return y;
 }
 
 #pragma endregion
@@ -1,63 +1,85 @@
 #pragma once
 
-#ifndef MATRIX_OPERATIONS_HXX
-#define MATRIX_OPERATIONS_HXX
+#ifndef MATRIX_OPERATORS_HXX
+#define MATRIX_OPERATORS_HXX
 
 #include "../../include/linalg/matrix.hxx"
+#include <sstream>
+#include <stdexcept>
 
 template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator+() {
-    return linalg::Matrix<T>();
+linalg::Matrix<T> linalg::Matrix<T>::operator+(const std::vector<std::vector<T>> &_oth) const {
+    linalg::Matrix<T> rhs(_oth, "def");
+    return linalg::Matrix<T>(*this + rhs);
 }
 
 template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator-() {
-    return linalg::Matrix<T>();
+linalg::Matrix<T> linalg::Matrix<T>::operator-(const std::vector<std::vector<T>> &_oth) const {
+    linalg::Matrix<T> rhs(_oth, "def");
+    return linalg::Matrix<T>(*this - rhs);
 }
 
 template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator+(const std::vector<std::vector<T>> &_oth) const {
-    return linalg::Matrix<T>();
+linalg::Matrix<T> linalg::Matrix<T>::operator*(const std::vector<std::vector<T>> &_oth) const {
+    return *this * linalg::Matrix<T>(_oth, "def");
 }
 
 template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator+(const linalg::Matrix<T> &_oth) const {
-    return linalg::Matrix<T>();
-}
+linalg::Matrix<T> linalg::Matrix<T>::operator*(const linalg::Matrix<T> &_oth) const {
+    if (cols != _oth.rows) {
+        std::ostringstream oss;
+        oss << "Matrix multiplication dimension mismatch: (" << rows << ", " << cols
+            << ") * (" << _oth.rows << ", " << _oth.cols << ").";
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator+(const long double &scalar) const {
-    return linalg::Matrix<T>();
-}
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator-(const std::vector<std::vector<T>> &_oth) const {
-    return linalg::Matrix<T>();
-}
+    // Sparse left operand: multiply straight from the (cached) compressed rows
+    if (matrix_state != linalg::Format::Dense) {
+        return crs().multiply(_oth);
+    }
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator-(const linalg::Matrix<T> &_oth) const {
-    return linalg::Matrix<T>();
-}
+    sync_dense();
+    _oth.sync_dense();
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator-(const long double &scalar) const {
-    return linalg::Matrix<T>();
-}
+    linalg::Matrix<T> result;
+    result.matrix_state = linalg::Format::Dense;
+    result.reshape_dense(rows, _oth.cols);
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator*(const std::vector<std::vector<T>> &_oth) const {
-    return linalg::Matrix<T>();
-}
+    linalg::kernels::gemm<T>(
+        rows, _oth.cols, cols,
+        matrix.data(), ld,
+        _oth.matrix.data(), _oth.ld,
+        result.matrix.data(), result.ld
+    );
 
-template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator*(const linalg::Matrix<T> &_oth) const {
-    return linalg::Matrix<T>();
+    return result;
 }
 
 template<typename T>
-linalg::Matrix<T> linalg::Matrix<T>::operator*(const long double &scalar) const {
-    return linalg::Matrix<T>();
+std::vector<T> linalg::Matrix<T>::operator*(const std::vector<T> &x) const {
+    if (x.size() != static_cast<std::size_t>(cols)) {
+        std::ostringstream oss;
+        oss << "Matrix-vector dimension mismatch: (" << rows << ", " << cols
+            << ") * (" << x.size() << ").";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::logic_error(oss.str());
+    }
+
+    // Sparse formats gather over the (cached) CRS rows; CCS and COO would
+    // otherwise scatter serially
+    if (matrix_state != linalg::Format::Dense) {
+        return crs().multiply(x);
+    }
+
+    std::vector<T> y(rows, static_cast<T>(0));
+
+    sync_dense();
+    linalg::kernels::gemv<T>(rows, cols, matrix.data(), ld, x.data(), y.data());
+
+    return y;
 }
 
-#endif // MATRIX_OPERATIONS_HXX
\ No newline at end of file
+#endif // MATRIX_OPERATORS_HXX
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#ifndef SPARSE_ARRAY_HXX
+#define SPARSE_ARRAY_HXX
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace linalg::detail {
+
+    // Storage of one CRS / CCS array.
+    //
+    // Either owns its elements in a std::vector or borrows a read-only range
+    // of memory kept alive by `keep_alive` (a mapped file, see
+    // src/io/mapped_file.hxx). Const access reads the borrowed range in place;
+    // any non-const access first copies it into owned storage, so nothing is
+    // ever written through a mapping. Copies are always owned, so no two arrays
+    // ever share a borrowed range.
+    template<typename T>
+    class SparseArray {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        SparseArray() = default;
+        SparseArray(std::vector<T> _values) : owned(std::move(_values)) { refresh(); }
+        SparseArray(std::initializer_list<T> _values) : owned(_values) { refresh(); }
+        explicit SparseArray(std::size_t n, const T& _val = T()) : owned(n, _val) { refresh(); }
+
+        // Refers to `n` elements at `_data` without copying them. The range is
+        // only ever read while borrowed, see `own`
+        static SparseArray borrow(const T* _data, std::size_t n, std::shared_ptr<const void> _keep_alive) {
+            SparseArray array;
+            array.first = const_cast<T*>(_data);
+            array.count = n;
+            array.keep_alive = std::move(_keep_alive);
+            return array;
+        }
+
+        SparseArray(const SparseArray& _oth) : owned(_oth.begin(), _oth.end()) { refresh(); }
+
+        SparseArray(SparseArray&& _oth) noexcept
+            : owned(std::move(_oth.owned)), first(_oth.first), count(_oth.count),
+              keep_alive(std::move(_oth.keep_alive)) {
+            _oth.first = nullptr;
+            _oth.count = 0;
+        }
+
+        SparseArray& operator=(const SparseArray& _oth) {
+            if (this == &_oth) return *this;
+
+            owned.assign(_oth.begin(), _oth.end());
+            keep_alive.reset();
+            refresh();
+            return *this;
+        }
+
+        SparseArray& operator=(SparseArray&& _oth) noexcept {
+            if (this == &_oth) return *this;
+
+            owned = std::move(_oth.owned);
+            first = _oth.first;
+            count = _oth.count;
+            keep_alive = std::move(_oth.keep_alive);
+
+            _oth.first = nullptr;
+            _oth.count = 0;
+            return *this;
+        }
+
+        bool borrowed() const { return keep_alive != nullptr; }
+
+        std::size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        // Writable access, borrowed ranges are copied out first
+        T* data() { own(); return first; }
+        iterator begin() { own(); return first; }
+        iterator end() { own(); return first + count; }
+        T& operator[](std::size_t idx) { own(); return first[idx]; }
+        T& back() { own(); return first[count - 1]; }
+
+        const T* data() const { return first; }
+        const_iterator begin() const { return first; }
+        const_iterator end() const { return first + count; }
+        const T& operator[](std::size_t idx) const { return first[idx]; }
+        const T& back() const { return first[count - 1]; }
+
+        // Size-changing operations, borrowed ranges are copied out first
+        void push_back(const T& _val) {
+            own();
+            owned.push_back(_val);
+            refresh();
+        }
+
+        iterator insert(const_iterator pos, const T& _val) {
+            std::size_t offset = pos - first;
+            own();
+            owned.insert(owned.begin() + offset, _val);
+            refresh();
+            return first + offset;
+        }
+
+        template<typename InputIt>
+        iterator insert(const_iterator pos, InputIt from, InputIt to) {
+            std::size_t offset = pos - first;
+            own();
+            owned.insert(owned.begin() + offset, from, to);
+            refresh();
+            return first + offset;
+        }
+
+        iterator erase(const_iterator pos) {
+            std::size_t offset = pos - first;
+            own();
+            owned.erase(owned.begin() + offset);
+            refresh();
+            return first + offset;
+        }
+
+        void resize(std::size_t n, const T& _val = T()) {
+            own();
+            owned.resize(n, _val);
+            refresh();
+        }
+
+        void assign(std::size_t n, const T& _val) {
+            keep_alive.reset();
+            owned.assign(n, _val);
+            refresh();
+        }
+
+        void reserve(std::size_t n) {
+            own();
+            owned.reserve(n);
+            refresh();
+        }
+
+        void clear() {
+            keep_alive.reset();
+            owned.clear();
+            refresh();
+        }
+
+    private:
+        void own() {
+            if (!keep_alive) return;
+
+            owned.assign(first, first + count);
+            keep_alive.reset();
+            refresh();
+        }
+
+        void refresh() {
+            first = owned.data();
+            count = owned.size();
+        }
+
+        std::vector<T>                          owned;
+        // Active range: `owned` or the borrowed memory
+        T*                                      first = nullptr;
+        std::size_t                             count = 0;
+        std::shared_ptr<const void>             keep_alive;
+    };
+
+}
+
+#endif // SPARSE_ARRAY_HXX
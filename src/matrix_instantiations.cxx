@@ -1,4 +1,14 @@
 #include "../include/linalg/matrix.hxx"
+#include "../include/linalg/solvers.hxx"
 
+template class linalg::Matrix<float>;
+template class linalg::Matrix<double>;
 template class linalg::Matrix<long double>;
-template class linalg::Matrix<int>;
\ No newline at end of file
+template class linalg::Matrix<int>;
+
+template class linalg::solvers::Jacobi<float>;
+template class linalg::solvers::Jacobi<double>;
+template class linalg::solvers::ILU0<float>;
+template class linalg::solvers::ILU0<double>;
+template class linalg::solvers::IC0<float>;
+template class linalg::solvers::IC0<double>;
@@ -0,0 +1,181 @@
+#pragma once
+
+#ifndef LINALG_THREAD_POOL_HXX
+#define LINALG_THREAD_POOL_HXX
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace linalg::parallel {
+
+    // Fixed-size pool of worker threads used by the compute kernels.
+    // One parallel region runs at a time; tasks are handed out dynamically
+    // through an atomic counter and the calling thread takes part in the work.
+    class ThreadPool {
+    public:
+        explicit ThreadPool(std::size_t n_threads) {
+            if (n_threads == 0) n_threads = 1;
+
+            // The calling thread is worker #0, so spawn one less
+            for (std::size_t t = 1; t < n_threads; ++t) {
+                workers.emplace_back([this, t] { worker_loop(t); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+
+            for (auto& worker : workers) worker.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const { return workers.size() + 1; }
+
+        // Calls `fn(task, thread_id)` for every task in [0, n_tasks).
+        // Nested calls from inside a task run serially on the current thread.
+        // If a task throws, the tasks not yet started are skipped and the first
+        // exception is rethrown on the calling thread once every worker is idle.
+        template<typename F>
+        void run(std::size_t n_tasks, F&& fn) {
+            if (n_tasks == 0) return;
+
+            if (n_tasks == 1 || workers.empty() || inside_region()) {
+                for (std::size_t task = 0; task < n_tasks; ++task) fn(task, std::size_t(0));
+                return;
+            }
+
+            std::lock_guard<std::mutex> region(region_mutex);
+
+            std::function<void(std::size_t, std::size_t)> body = std::forward<F>(fn);
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                job = &body;
+                job_tasks = n_tasks;
+                next_task.store(0, std::memory_order_relaxed);
+                active = workers.size();
+                ++generation;
+            }
+            wake.notify_all();
+
+            {
+                RegionGuard guard;
+                drain(0);
+            }
+
+            std::exception_ptr failure;
+            {
+                std::unique_lock<std::mutex> lock(state_mutex);
+                done.wait(lock, [this] { return active == 0; });
+                job = nullptr;
+                failure = std::exchange(error, nullptr);
+            }
+
+            if (failure) std::rethrow_exception(failure);
+        }
+
+    private:
+        static bool& inside_region() {
+            thread_local bool flag = false;
+            return flag;
+        }
+
+        // Marks the calling thread as inside a region until the scope ends
+        struct RegionGuard {
+            RegionGuard() { inside_region() = true; }
+            ~RegionGuard() { inside_region() = false; }
+        };
+
+        void drain(std::size_t thread_id) {
+            for (;;) {
+                std::size_t task = next_task.fetch_add(1, std::memory_order_relaxed);
+                if (task >= job_tasks) break;
+
+                try {
+                    (*job)(task, thread_id);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(state_mutex);
+                    if (!error) error = std::current_exception();
+                    next_task.store(job_tasks, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void worker_loop(std::size_t thread_id) {
+            inside_region() = true;
+            std::size_t seen = 0;
+
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(state_mutex);
+                    wake.wait(lock, [&] { return stopping || generation != seen; });
+                    if (stopping) return;
+                    seen = generation;
+                }
+
+                drain(thread_id);
+
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex);
+                    if (--active == 0) done.notify_one();
+                }
+            }
+        }
+
+        std::vector<std::thread>                                workers;
+
+        std::mutex                                              region_mutex;
+        std::mutex                                              state_mutex;
+        std::condition_variable                                 wake;
+        std::condition_variable                                 done;
+
+        std::function<void(std::size_t, std::size_t)>*          job = nullptr;
+        std::size_t                                             job_tasks = 0;
+        std::atomic<std::size_t>                                next_task{0};
+        std::size_t                                             active = 0;
+        std::size_t                                             generation = 0;
+        bool                                                    stopping = false;
+        // First exception thrown by a task of the current region
+        std::exception_ptr                                      error;
+    };
+
+    // Number of threads used by the kernels.
+    // `LINALG_NUM_THREADS` overrides the hardware concurrency.
+    inline std::size_t default_thread_count() {
+        if (const char* env = std::getenv("LINALG_NUM_THREADS")) {
+            long requested = std::strtol(env, nullptr, 10);
+            if (requested > 0) return static_cast<std::size_t>(requested);
+        }
+
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw == 0 ? 1 : hw;
+    }
+
+    inline ThreadPool& pool() {
+        static ThreadPool instance(default_thread_count());
+        return instance;
+    }
+
+    // Splits [0, n_tasks) across the global pool.
+    template<typename F>
+    void parallel_for(std::size_t n_tasks, F&& fn) {
+        pool().run(n_tasks, std::forward<F>(fn));
+    }
+
+}
+
+#endif // LINALG_THREAD_POOL_HXX
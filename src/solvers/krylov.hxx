@@ -0,0 +1,320 @@
+#pragma once
+
+#ifndef LINALG_KRYLOV_HXX
+#define LINALG_KRYLOV_HXX
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "solver.hxx"
+#include "preconditioners.hxx"
+#include "../kernels/vector.hxx"
+#include "../diagnostics/metrics.hxx"
+
+// Krylov solvers for A x = b with A square CRS (anything `csr_view<T>` accepts).
+//
+// `x` holds the initial guess on entry (an empty vector starts from zero) and
+// the solution on exit. `M` is any preconditioner with `apply(r, z, n)`; CG
+// applies it on the left, BiCGSTAB and GMRES on the right. The tolerance is
+// always checked against the unpreconditioned residual ||b - A x||.
+
+namespace linalg::solvers {
+
+    // Conjugate gradient, A symmetric positive definite (M too)
+    template<typename A_t, typename T, typename P = Identity<T>>
+    SolverResult<T> cg(const A_t& A, const std::vector<T>& b, std::vector<T>& x,
+                       const P& M = P(), const SolverOptions<T>& options = {}) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::solve);
+        auto solve_start = detail::Clock::now();
+
+        auto view = csr_view<T>(A);
+        detail::check_system(view, b, x);
+
+        std::size_t n = view.n;
+        SolverResult<T> result;
+
+        T b_norm = std::sqrt(linalg::kernels::dot(n, b.data(), b.data()));
+        if (b_norm == static_cast<T>(0)) {
+            x.assign(n, static_cast<T>(0));
+            result.status = SolverStatus::converged;
+            result.total_seconds = detail::seconds_since(solve_start);
+            return result;
+        }
+
+        std::vector<T> r(n), z(n), p(n), q(n);
+
+        view.multiply(x.data(), q.data());
+        T rr = linalg::kernels::sub_norm2(n, b.data(), q.data(), r.data());
+        result.residual_norm = std::sqrt(rr);
+        result.relative_residual = result.residual_norm / b_norm;
+
+        if (result.relative_residual > options.tolerance && options.max_iterations > 0) {
+            M.apply(r.data(), z.data(), n);
+            p = z;
+            T rz = linalg::kernels::dot(n, r.data(), z.data());
+
+            auto iteration_start = detail::Clock::now();
+            while (true) {
+                view.multiply(p.data(), q.data());
+
+                T pq = linalg::kernels::dot(n, p.data(), q.data());
+                if (pq == static_cast<T>(0)) {
+                    result.status = SolverStatus::breakdown;
+                    break;
+                }
+
+                T alpha = rz / pq;
+                linalg::kernels::axpy(n, alpha, p.data(), x.data());
+                rr = linalg::kernels::axpy_dot(n, -alpha, q.data(), r.data(), r.data());
+
+                if (detail::finish_iteration(result, options, std::sqrt(rr), b_norm, solve_start, iteration_start)) break;
+
+                M.apply(r.data(), z.data(), n);
+                T rz_next = linalg::kernels::dot(n, r.data(), z.data());
+
+                linalg::kernels::xpby(n, z.data(), rz_next / rz, p.data());
+                rz = rz_next;
+            }
+        }
+        else if (result.relative_residual <= options.tolerance) {
+            result.status = SolverStatus::converged;
+        }
+
+        result.total_seconds = detail::seconds_since(solve_start);
+        LINALG_LOG_INFO("CG finished after {} iterations, relative residual {}", result.iterations, result.relative_residual);
+        return result;
+    }
+
+    // Stabilized bi-conjugate gradient for general nonsymmetric A
+    template<typename A_t, typename T, typename P = Identity<T>>
+    SolverResult<T> bicgstab(const A_t& A, const std::vector<T>& b, std::vector<T>& x,
+                             const P& M = P(), const SolverOptions<T>& options = {}) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::solve);
+        auto solve_start = detail::Clock::now();
+
+        auto view = csr_view<T>(A);
+        detail::check_system(view, b, x);
+
+        std::size_t n = view.n;
+        SolverResult<T> result;
+
+        T b_norm = std::sqrt(linalg::kernels::dot(n, b.data(), b.data()));
+        if (b_norm == static_cast<T>(0)) {
+            x.assign(n, static_cast<T>(0));
+            result.status = SolverStatus::converged;
+            result.total_seconds = detail::seconds_since(solve_start);
+            return result;
+        }
+
+        std::vector<T> r(n), r_hat(n), p(n, static_cast<T>(0)), v(n, static_cast<T>(0));
+        std::vector<T> p_hat(n), s_hat(n), t(n);
+
+        view.multiply(x.data(), t.data());
+        T rr = linalg::kernels::sub_norm2(n, b.data(), t.data(), r.data());
+        result.residual_norm = std::sqrt(rr);
+        result.relative_residual = result.residual_norm / b_norm;
+
+        if (result.relative_residual > options.tolerance && options.max_iterations > 0) {
+            r_hat = r;
+            T rho = static_cast<T>(1), alpha = static_cast<T>(1), omega = static_cast<T>(1);
+
+            // The recurred residual can drift from b - A x on nonnormal A. Before
+            // accepting convergence, recompute it; if it is still too large, the
+            // recurrence restarts from the true residual.
+            auto checked_norm = [&](T recurred) {
+                if (recurred / b_norm > options.tolerance) return recurred;
+
+                view.multiply(x.data(), t.data());
+                T norm = std::sqrt(linalg::kernels::sub_norm2(n, b.data(), t.data(), r.data()));
+
+                if (norm / b_norm > options.tolerance) {
+                    LINALG_LOG_DEBUG("BiCGSTAB: residual gap at iteration {}, restarting", result.iterations + 1);
+
+                    r_hat = r;
+                    rho = alpha = omega = static_cast<T>(1);
+                    std::fill(p.begin(), p.end(), static_cast<T>(0));
+                    std::fill(v.begin(), v.end(), static_cast<T>(0));
+                }
+                return norm;
+            };
+
+            auto iteration_start = detail::Clock::now();
+            while (true) {
+                T rho_next = linalg::kernels::dot(n, r_hat.data(), r.data());
+                if (rho_next == static_cast<T>(0)) {
+                    result.status = SolverStatus::breakdown;
+                    break;
+                }
+
+                // p = r + beta * (p - omega * v)
+                linalg::kernels::axpy(n, -omega, v.data(), p.data());
+                linalg::kernels::xpby(n, r.data(), (rho_next / rho) * (alpha / omega), p.data());
+
+                M.apply(p.data(), p_hat.data(), n);
+                view.multiply(p_hat.data(), v.data());
+
+                T r_hat_v = linalg::kernels::dot(n, r_hat.data(), v.data());
+                if (r_hat_v == static_cast<T>(0)) {
+                    result.status = SolverStatus::breakdown;
+                    break;
+                }
+                alpha = rho_next / r_hat_v;
+
+                // s = r - alpha * v, kept in r
+                T ss = linalg::kernels::axpy_dot(n, -alpha, v.data(), r.data(), r.data());
+                linalg::kernels::axpy(n, alpha, p_hat.data(), x.data());
+
+                if (std::sqrt(ss) / b_norm <= options.tolerance) {
+                    rho = rho_next;
+                    if (detail::finish_iteration(result, options, checked_norm(std::sqrt(ss)), b_norm, solve_start, iteration_start)) break;
+                    continue;
+                }
+
+                M.apply(r.data(), s_hat.data(), n);
+                view.multiply(s_hat.data(), t.data());
+
+                T tt = linalg::kernels::dot(n, t.data(), t.data());
+                omega = tt == static_cast<T>(0) ? static_cast<T>(0) : linalg::kernels::dot(n, t.data(), r.data()) / tt;
+                linalg::kernels::axpy(n, omega, s_hat.data(), x.data());
+                rr = linalg::kernels::axpy_dot(n, -omega, t.data(), r.data(), r.data());
+                rho = rho_next;
+
+                if (omega == static_cast<T>(0)) {
+                    result.status = SolverStatus::breakdown;
+                    break;
+                }
+                if (detail::finish_iteration(result, options, checked_norm(std::sqrt(rr)), b_norm, solve_start, iteration_start)) break;
+            }
+        }
+        else if (result.relative_residual <= options.tolerance) {
+            result.status = SolverStatus::converged;
+        }
+
+        result.total_seconds = detail::seconds_since(solve_start);
+        LINALG_LOG_INFO("BiCGSTAB finished after {} iterations, relative residual {}", result.iterations, result.relative_residual);
+        return result;
+    }
+
+    // Restarted GMRES(m), m = `options.restart`. Orthogonalization is modified
+    // Gram-Schmidt; the residual is tracked through Givens rotations of the
+    // Hessenberg matrix, so each iteration costs one product and one apply of M.
+    template<typename A_t, typename T, typename P = Identity<T>>
+    SolverResult<T> gmres(const A_t& A, const std::vector<T>& b, std::vector<T>& x,
+                          const P& M = P(), const SolverOptions<T>& options = {}) {
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::solve);
+        auto solve_start = detail::Clock::now();
+
+        auto view = csr_view<T>(A);
+        detail::check_system(view, b, x);
+
+        if (options.restart == 0) {
+            LINALG_LOG_ERROR("GMRES restart length must be positive.");
+            throw std::logic_error("GMRES restart length must be positive.");
+        }
+
+        std::size_t n = view.n;
+        std::size_t m = options.restart;
+        SolverResult<T> result;
+
+        T b_norm = std::sqrt(linalg::kernels::dot(n, b.data(), b.data()));
+        if (b_norm == static_cast<T>(0)) {
+            x.assign(n, static_cast<T>(0));
+            result.status = SolverStatus::converged;
+            result.total_seconds = detail::seconds_since(solve_start);
+            return result;
+        }
+
+        std::vector<std::vector<T>> V(m + 1, std::vector<T>(n));
+        // Hessenberg matrix, column-major (m + 1) x m
+        std::vector<T> H((m + 1) * m), cs(m), sn(m), g(m + 1), y(m);
+        std::vector<T> w(n), z(n);
+
+        // x += M * (V y) over the first k basis vectors
+        auto update_solution = [&](std::size_t k) {
+            for (std::size_t i = k; i-- > 0;) {
+                T sum = g[i];
+                for (std::size_t j = i + 1; j < k; ++j) sum -= H[j * (m + 1) + i] * y[j];
+                y[i] = sum / H[i * (m + 1) + i];
+            }
+
+            std::fill(w.begin(), w.end(), static_cast<T>(0));
+            for (std::size_t i = 0; i < k; ++i) linalg::kernels::axpy(n, y[i], V[i].data(), w.data());
+
+            M.apply(w.data(), z.data(), n);
+            linalg::kernels::axpy(n, static_cast<T>(1), z.data(), x.data());
+        };
+
+        bool done = options.max_iterations == 0;
+        while (!done) {
+            view.multiply(x.data(), w.data());
+            T beta = std::sqrt(linalg::kernels::sub_norm2(n, b.data(), w.data(), V[0].data()));
+
+            result.residual_norm = beta;
+            result.relative_residual = beta / b_norm;
+            if (result.relative_residual <= options.tolerance) {
+                result.status = SolverStatus::converged;
+                break;
+            }
+
+            linalg::kernels::scale(n, static_cast<T>(1) / beta, V[0].data());
+            std::fill(g.begin(), g.end(), static_cast<T>(0));
+            g[0] = beta;
+
+            std::size_t k = 0;
+            auto iteration_start = detail::Clock::now();
+            for (std::size_t j = 0; j < m && !done; ++j) {
+                T* h = H.data() + j * (m + 1);
+
+                M.apply(V[j].data(), z.data(), n);
+                view.multiply(z.data(), w.data());
+
+                // MGS: subtracting h[i] V[i] from w also yields h[i + 1] = w . V[i + 1]
+                h[0] = linalg::kernels::dot(n, w.data(), V[0].data());
+                for (std::size_t i = 0; i < j; ++i) {
+                    h[i + 1] = linalg::kernels::axpy_dot(n, -h[i], V[i].data(), w.data(), V[i + 1].data());
+                }
+                T ww = linalg::kernels::axpy_dot(n, -h[j], V[j].data(), w.data(), w.data());
+                h[j + 1] = std::sqrt(ww);
+
+                for (std::size_t i = 0; i < j; ++i) {
+                    T hi = cs[i] * h[i] + sn[i] * h[i + 1];
+                    h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+                    h[i] = hi;
+                }
+
+                T radius = std::hypot(h[j], h[j + 1]);
+                if (radius == static_cast<T>(0)) {
+                    result.status = SolverStatus::breakdown;
+                    done = true;
+                    break;
+                }
+                cs[j] = h[j] / radius;
+                sn[j] = h[j + 1] / radius;
+                h[j] = radius;
+                h[j + 1] = static_cast<T>(0);
+
+                g[j + 1] = -sn[j] * g[j];
+                g[j] = cs[j] * g[j];
+                k = j + 1;
+
+                // Zero `ww` means the Krylov space is invariant and g[j + 1] is zero too
+                if (ww > static_cast<T>(0)) {
+                    linalg::kernels::scale(n, static_cast<T>(1) / std::sqrt(ww), w.data());
+                    std::swap(w, V[j + 1]);
+                }
+
+                done = detail::finish_iteration(result, options, std::abs(g[j + 1]), b_norm, solve_start, iteration_start);
+            }
+
+            if (k > 0) update_solution(k);
+        }
+
+        result.total_seconds = detail::seconds_since(solve_start);
+        LINALG_LOG_INFO("GMRES({}) finished after {} iterations, relative residual {}", m, result.iterations, result.relative_residual);
+        return result;
+    }
+
+}
+
+#endif // LINALG_KRYLOV_HXX
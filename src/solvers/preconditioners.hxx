@@ -0,0 +1,228 @@
+#pragma once
+
+#ifndef LINALG_PRECONDITIONERS_HXX
+#define LINALG_PRECONDITIONERS_HXX
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "solver.hxx"
+#include "../kernels/vector.hxx"
+
+// Preconditioners take a square CRS matrix (anything `csr_view<T>` accepts) and
+// expose `apply(r, z)`, which computes z = M^-1 r.
+//
+// ILU(0) and IC(0) keep the sparsity pattern of A, so the factors are stored
+// on a copy of A's arrays. Their triangular solves are sequential: every row
+// depends on the rows before it.
+
+namespace linalg::solvers {
+
+    // M = I
+    template<typename T>
+    class Identity {
+    public:
+        void apply(const T* r, T* z, std::size_t n) const {
+            linalg::kernels::for_each_block(n, [&](std::size_t begin, std::size_t end) {
+                std::copy(r + begin, r + end, z + begin);
+            });
+        }
+    };
+
+    // M = diag(A)
+    template<typename T>
+    class Jacobi {
+    public:
+        template<typename A_t>
+        explicit Jacobi(const A_t& A) {
+            auto view = csr_view<T>(A);
+            inverse_diagonal.assign(view.n, static_cast<T>(0));
+
+            for (std::size_t i = 0; i < view.n; ++i) {
+                T diagonal = static_cast<T>(0);
+                for (auto k = view.pointers[i]; k < view.pointers[i + 1]; ++k) {
+                    if (static_cast<std::size_t>(view.indexes[k]) == i) diagonal += view.values[k];
+                }
+                if (diagonal == static_cast<T>(0)) throw_pivot("Jacobi", i);
+
+                inverse_diagonal[i] = static_cast<T>(1) / diagonal;
+            }
+        }
+
+        void apply(const T* r, T* z, std::size_t n) const {
+            linalg::metrics::add(linalg::metrics::Counter::flops, n);
+
+            linalg::kernels::for_each_block(n, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) z[i] = inverse_diagonal[i] * r[i];
+            });
+        }
+
+    private:
+        [[noreturn]] static void throw_pivot(const char* name, std::size_t row) {
+            std::ostringstream oss;
+            oss << name << " preconditioner: zero diagonal in row " << row << ".";
+
+            LINALG_LOG_ERROR(oss.str());
+            throw std::runtime_error(oss.str());
+        }
+
+        std::vector<T>                          inverse_diagonal;
+    };
+
+    namespace detail {
+
+        // Copy of a CRS pattern with the position of every diagonal entry.
+        // Column indexes must be sorted within each row. The source may use
+        // any index type `J`; the copy is stored with `I`.
+        template<typename T, typename I>
+        struct Factorization {
+            std::size_t                         n = 0;
+            std::vector<I>                      pointers;
+            std::vector<I>                      indexes;
+            std::vector<T>                      values;
+            std::vector<I>                      diagonal;
+
+            template<typename J>
+            Factorization(const CsrView<T, J>& A, const char* name)
+                : n(A.n),
+                  pointers(A.pointers, A.pointers + A.n + 1),
+                  indexes(A.indexes, A.indexes + A.nnz()),
+                  values(A.values, A.values + A.nnz()),
+                  diagonal(A.n) {
+                // A narrower `I` than the source must still hold every position
+                linalg::detail::check_index_range<I>(static_cast<long long>(A.nnz()), "Nonzero count");
+
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto first = indexes.begin() + pointers[i];
+                    auto last = indexes.begin() + pointers[i + 1];
+                    auto it = std::lower_bound(first, last, static_cast<I>(i));
+
+                    if (it == last || static_cast<std::size_t>(*it) != i) throw_pivot(name, i);
+                    diagonal[i] = static_cast<I>(it - indexes.begin());
+                }
+            }
+
+            [[noreturn]] static void throw_pivot(const char* name, std::size_t row) {
+                std::ostringstream oss;
+                oss << name << " preconditioner: missing or non-positive pivot in row " << row << ".";
+
+                LINALG_LOG_ERROR(oss.str());
+                throw std::runtime_error(oss.str());
+            }
+        };
+
+    }
+
+    // Incomplete LU with zero fill-in: L (unit lower) and U share A's pattern.
+    // `I` is the index type of the stored factors and is independent of the
+    // index type of A, e.g. `ILU0<double>` accepts a `Matrix<double, Format::CRS, std::int32_t>`
+    template<typename T, typename I = long long>
+    class ILU0 {
+    public:
+        template<typename A_t>
+        explicit ILU0(const A_t& A) : factors(csr_view<T>(A), "ILU(0)") {
+            auto& f = factors;
+            std::vector<I> position(f.n, static_cast<I>(-1));
+
+            // IKJ variant: row i is reduced by every earlier row k it references,
+            // keeping only updates that land on row i's own pattern
+            for (std::size_t i = 0; i < f.n; ++i) {
+                for (auto k = f.pointers[i]; k < f.pointers[i + 1]; ++k) position[f.indexes[k]] = k;
+
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) {
+                    auto row = f.indexes[k];
+                    f.values[k] /= f.values[f.diagonal[row]];
+
+                    for (auto j = f.diagonal[row] + 1; j < f.pointers[row + 1]; ++j) {
+                        auto target = position[f.indexes[j]];
+                        if (target >= 0) f.values[target] -= f.values[k] * f.values[j];
+                    }
+                }
+
+                if (f.values[f.diagonal[i]] == static_cast<T>(0)) f.throw_pivot("ILU(0)", i);
+                for (auto k = f.pointers[i]; k < f.pointers[i + 1]; ++k) position[f.indexes[k]] = -1;
+            }
+        }
+
+        // z = U^-1 L^-1 r
+        void apply(const T* r, T* z, std::size_t n) const {
+            const auto& f = factors;
+            linalg::metrics::add(linalg::metrics::Counter::flops, 2 * f.values.size());
+
+            for (std::size_t i = 0; i < n; ++i) {
+                T sum = r[i];
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) sum -= f.values[k] * z[f.indexes[k]];
+                z[i] = sum;
+            }
+            for (std::size_t i = n; i-- > 0;) {
+                T sum = z[i];
+                for (auto k = f.diagonal[i] + 1; k < f.pointers[i + 1]; ++k) sum -= f.values[k] * z[f.indexes[k]];
+                z[i] = sum / f.values[f.diagonal[i]];
+            }
+        }
+
+    private:
+        detail::Factorization<T, I>             factors;
+    };
+
+    // Incomplete Cholesky with zero fill-in for symmetric positive definite A.
+    // Only the lower triangle of A is read; L is stored row-wise and L^T is
+    // applied by scattering columns. `I` is chosen as for ILU0.
+    template<typename T, typename I = long long>
+    class IC0 {
+    public:
+        template<typename A_t>
+        explicit IC0(const A_t& A) : factors(csr_view<T>(A), "IC(0)") {
+            auto& f = factors;
+            std::vector<I> position(f.n, static_cast<I>(-1));
+
+            // Row-wise (left-looking) IC: L(i, j) = (A(i, j) - sum_k L(i, k) L(j, k)) / L(j, j)
+            for (std::size_t i = 0; i < f.n; ++i) {
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) position[f.indexes[k]] = k;
+
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) {
+                    auto row = f.indexes[k];
+
+                    T sum = f.values[k];
+                    for (auto j = f.pointers[row]; j < f.diagonal[row]; ++j) {
+                        auto target = position[f.indexes[j]];
+                        if (target >= 0 && target < k) sum -= f.values[target] * f.values[j];
+                    }
+                    f.values[k] = sum / f.values[f.diagonal[row]];
+                }
+
+                T pivot = f.values[f.diagonal[i]];
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) pivot -= f.values[k] * f.values[k];
+                if (!(pivot > static_cast<T>(0))) f.throw_pivot("IC(0)", i);
+
+                f.values[f.diagonal[i]] = std::sqrt(pivot);
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) position[f.indexes[k]] = -1;
+            }
+        }
+
+        // z = L^-T L^-1 r
+        void apply(const T* r, T* z, std::size_t n) const {
+            const auto& f = factors;
+            linalg::metrics::add(linalg::metrics::Counter::flops, 2 * f.values.size());
+
+            for (std::size_t i = 0; i < n; ++i) {
+                T sum = r[i];
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) sum -= f.values[k] * z[f.indexes[k]];
+                z[i] = sum / f.values[f.diagonal[i]];
+            }
+            for (std::size_t i = n; i-- > 0;) {
+                z[i] /= f.values[f.diagonal[i]];
+                for (auto k = f.pointers[i]; k < f.diagonal[i]; ++k) z[f.indexes[k]] -= f.values[k] * z[i];
+            }
+        }
+
+    private:
+        detail::Factorization<T, I>             factors;
+    };
+
+}
+
+#endif // LINALG_PRECONDITIONERS_HXX
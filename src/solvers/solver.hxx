@@ -0,0 +1,188 @@
+#pragma once
+
+#ifndef LINALG_SOLVER_HXX
+#define LINALG_SOLVER_HXX
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "../../include/linalg/matrix.hxx"
+#include "../kernels/spmv.hxx"
+#include "../diagnostics/log.hxx"
+
+namespace linalg::solvers {
+
+    // Square CRS matrix the solvers and preconditioners read in place.
+    // Built from `Matrix<T>::CRS` or `Matrix<T, Format::CRS, I>` without a copy;
+    // the source must outlive the view.
+    template<typename T, typename I = long long>
+    struct CsrView {
+        std::size_t                             n = 0;
+        const I*                                pointers = nullptr;
+        const I*                                indexes = nullptr;
+        const T*                                values = nullptr;
+
+        std::size_t nnz() const { return n == 0 ? 0 : static_cast<std::size_t>(pointers[n]); }
+
+        // y = A * x
+        void multiply(const T* x, T* y) const {
+            linalg::kernels::spmv<T, I>(n, pointers, indexes, values, x, y);
+        }
+    };
+
+    template<typename T, typename I>
+    CsrView<T, I> csr_view(const CsrView<T, I>& A) {
+        return A;
+    }
+
+    template<typename T>
+    CsrView<T, long long> csr_view(const typename linalg::Matrix<T>::CRS& A) {
+        std::size_t n = A.row_pointers.empty() ? 0 : A.row_pointers.size() - 1;
+        return CsrView<T, long long>{n, A.row_pointers.data(), A.col_indexes.data(), A.values.data()};
+    }
+
+    // Any format: reads the cached CRS, which stays valid until `A` is written
+    template<typename T>
+    CsrView<T, long long> csr_view(const linalg::Matrix<T>& A) {
+        if (A.get_rows() != A.get_cols()) {
+            std::ostringstream oss;
+            oss << "Iterative solvers need a square matrix, got (" << A.get_rows() << ", " << A.get_cols() << ").";
+
+            LINALG_LOG_ERROR(oss.str());
+            throw std::logic_error(oss.str());
+        }
+
+        return csr_view<T>(A.crs());
+    }
+
+    template<typename T, typename I>
+    CsrView<T, I> csr_view(const linalg::Matrix<T, linalg::Format::CRS, I>& A) {
+        if (A.get_rows() != A.get_cols()) {
+            std::ostringstream oss;
+            oss << "Iterative solvers need a square matrix, got (" << A.get_rows() << ", " << A.get_cols() << ").";
+
+            LINALG_LOG_ERROR(oss.str());
+            throw std::logic_error(oss.str());
+        }
+
+        const auto& storage = A.storage();
+        return CsrView<T, I>{static_cast<std::size_t>(A.get_rows()),
+                             storage.pointers.data(), storage.indexes.data(), storage.values.data()};
+    }
+
+    // State after one iteration, handed to `SolverOptions::on_iteration`
+    template<typename T>
+    struct IterationInfo {
+        std::size_t                             iteration = 0;
+        T                                       residual_norm = 0;
+        // `residual_norm / ||b||`, compared against the tolerance
+        T                                       relative_residual = 0;
+        // Wall time of this iteration and since the solve started
+        double                                  seconds = 0;
+        double                                  elapsed = 0;
+    };
+
+    template<typename T>
+    struct SolverOptions {
+        std::size_t                             max_iterations = 1000;
+        // Stop once ||b - A x|| <= tolerance * ||b||
+        T                                       tolerance = static_cast<T>(1e-8);
+        // Krylov basis size of restarted GMRES
+        std::size_t                             restart = 30;
+        // Called after every iteration; returning false stops the solve
+        std::function<bool(const IterationInfo<T>&)> on_iteration;
+    };
+
+    enum class SolverStatus {
+        converged,
+        max_iterations,
+        // A scalar the method divides by became zero (e.g. BiCGSTAB rho)
+        breakdown,
+        // `on_iteration` returned false before the tolerance was reached
+        stopped
+    };
+
+    template<typename T>
+    struct SolverResult {
+        SolverStatus                            status = SolverStatus::max_iterations;
+        std::size_t                             iterations = 0;
+        T                                       residual_norm = 0;
+        T                                       relative_residual = 0;
+        // Per-iteration wall time, in iteration order
+        std::vector<double>                     iteration_seconds;
+        double                                  total_seconds = 0;
+
+        bool converged() const { return status == SolverStatus::converged; }
+    };
+
+    namespace detail {
+
+        using Clock = std::chrono::steady_clock;
+
+        inline double seconds_since(Clock::time_point start) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        // Checks the system, sizes `x` (zero initial guess when empty)
+        template<typename T, typename I>
+        void check_system(const CsrView<T, I>& A, const std::vector<T>& b, std::vector<T>& x) {
+            static_assert(std::is_floating_point_v<T>, "Iterative solvers need a floating point type");
+
+            if (x.empty()) x.assign(A.n, static_cast<T>(0));
+
+            if (b.size() != A.n || x.size() != A.n) {
+                std::ostringstream oss;
+                oss << "Solver dimension mismatch: A is (" << A.n << ", " << A.n << "), b has "
+                    << b.size() << " entries and x has " << x.size() << ".";
+
+                LINALG_LOG_ERROR(oss.str());
+                throw std::logic_error(oss.str());
+            }
+        }
+
+        // Books one iteration into `result` and runs the callback.
+        // Returns true when the solve should end.
+        template<typename T>
+        bool finish_iteration(SolverResult<T>& result, const SolverOptions<T>& options, T residual_norm,
+                              T b_norm, Clock::time_point solve_start, Clock::time_point& iteration_start) {
+            auto now = Clock::now();
+
+            IterationInfo<T> info;
+            info.iteration = ++result.iterations;
+            info.residual_norm = residual_norm;
+            info.relative_residual = residual_norm / b_norm;
+            info.seconds = std::chrono::duration<double>(now - iteration_start).count();
+            info.elapsed = std::chrono::duration<double>(now - solve_start).count();
+
+            result.residual_norm = info.residual_norm;
+            result.relative_residual = info.relative_residual;
+            result.iteration_seconds.push_back(info.seconds);
+
+            LINALG_LOG_DEBUG("Iteration {}: relative residual {}", info.iteration, info.relative_residual);
+
+            // The callback sees every iteration, but cannot turn a converged
+            // solve into a stopped one
+            bool keep_going = !options.on_iteration || options.on_iteration(info);
+
+            if (info.relative_residual <= options.tolerance) {
+                result.status = SolverStatus::converged;
+                return true;
+            }
+            if (!keep_going) {
+                result.status = SolverStatus::stopped;
+                return true;
+            }
+
+            iteration_start = Clock::now();
+            return result.iterations >= options.max_iterations;
+        }
+
+    }
+
+}
+
+#endif // LINALG_SOLVER_HXX
@@ -3,11 +3,13 @@
 #ifndef CCS_MATRIX_DECLARE
 #define CCS_MATRIX_DECLARE
 
+#include <algorithm>
 #include <iostream>
 #include "../../include/linalg/matrix.hxx"
 
 template<typename T>
 typename linalg::Matrix<T>::CCS linalg::Matrix<T>::init_ccs(const std::vector<std::vector<T>> _matrix) {
+    linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
     CCS mtx;
 
     if (_matrix.empty()) {
@@ -34,11 +36,17 @@ typename linalg::Matrix<T>::CCS linalg::Matrix<T>::init_ccs(const std::vector<st
         mtx.col_pointers.push_back(mtx.col_pointers.back() + cnt);  // COL_INDEX[i] = COL_INDEX[i-1] + nnz (nonzero count)
     }
 
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+    linalg::metrics::add(linalg::metrics::Counter::nnz_touched, mtx.values.size());
+    linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                         mtx.values.size() * (sizeof(T) + sizeof(long long)) +
+                         mtx.col_pointers.size() * sizeof(long long));
+
     return mtx;
 }
 
 template<typename T>
-T& linalg::Matrix<T>::CCS::operator()(int i, int j) {
+const T& linalg::Matrix<T>::CCS::operator()(int i, int j) const {
     if (j < 0 || j >= col_pointers.size() - 1) {
         throw std::out_of_range("CCS column index out of bounds.\n");
     }
@@ -46,40 +54,85 @@ T& linalg::Matrix<T>::CCS::operator()(int i, int j) {
     int col_start = col_pointers[j];
     int col_end = col_pointers[j + 1];
 
-    for ( long long idx = col_start; idx < col_end; ++idx) {
+    for (long long idx = col_start; idx < col_end; ++idx) {
         if (row_indexes[idx] == i) {
             return values[idx];
         }
     }
 
-    static T def = static_cast<T>(0);
+    static const T def = static_cast<T>(0);
     return def;
 }
 
 template<typename T>
-const T& linalg::Matrix<T>::CCS::operator()(int i, int j) const {
-    if (j < 0 || j >= col_pointers.size() - 1) {
-        throw std::out_of_range("CCS column index out of bounds.\n");
+void linalg::Matrix<T>::CCS::set(int i, int j, const T& _val) {
+    if (j < 0 || j >= static_cast<long long>(col_pointers.size()) - 1) {
+        LINALG_LOG_ERROR("CCS column index-{} out of bounds", j);
+        throw std::out_of_range("CCS column index out of bounds.");
     }
 
-    int col_start = col_pointers[j];
-    int col_end = col_pointers[j + 1];
+    // The arrays hold no row count, `Matrix::set` checks the upper bound
+    if (i < 0) {
+        LINALG_LOG_ERROR("CCS row index-{} out of bounds", i);
+        throw std::out_of_range("CCS row index out of bounds.");
+    }
 
-    for (long long idx = col_start; idx < col_end; ++idx) {
-        if (row_indexes[idx] == i) {
-            return values[idx];
+    // Row indexes are sorted within each column
+    auto col_begin = row_indexes.begin() + col_pointers[j];
+    auto col_end = row_indexes.begin() + col_pointers[j + 1];
+    long long pos = std::lower_bound(col_begin, col_end, static_cast<long long>(i)) - row_indexes.begin();
+
+    if (pos < col_pointers[j + 1] && row_indexes[pos] == i) {
+        if (_val != 0) {
+            values[pos] = _val;
+            return;
         }
+
+        values.erase(values.begin() + pos);
+        row_indexes.erase(row_indexes.begin() + pos);
+        for (std::size_t k = j + 1; k < col_pointers.size(); ++k) col_pointers[k]--;
+
+        linalg::metrics::add(linalg::metrics::Counter::erases);
+        return;
     }
 
-    static T def = static_cast<T>(0);
-    return def;
+    if (_val == 0) return;
+
+    row_indexes.insert(row_indexes.begin() + pos, static_cast<long long>(i));
+    values.insert(values.begin() + pos, _val);
+    for (std::size_t k = j + 1; k < col_pointers.size(); ++k) col_pointers[k]++;
+
+    linalg::metrics::add(linalg::metrics::Counter::inserts);
 }
 
 template<typename T>
-void linalg::Matrix<T>::CCS::set(int i, int j, const T& _val) {
-    (void)sizeof(i);
-    (void)sizeof(j);
-    (void)sizeof(_val);
+std::vector<T> linalg::Matrix<T>::CCS::transpose_multiply(const std::vector<T>& x) const {
+    if (col_pointers.empty()) return std::vector<T>();
+
+    std::vector<T> y(col_pointers.size() - 1);
+
+    // Column j of A is row j of A^T, so the CRS gather kernel applies as is
+    linalg::kernels::spmv<T, long long>(
+        y.size(), col_pointers.data(), row_indexes.data(), values.data(), x.data(), y.data()
+    );
+
+    return y;
+}
+
+template<typename T>
+linalg::Matrix<T> linalg::Matrix<T>::CCS::transpose_multiply(const linalg::Matrix<T>& X) const {
+    linalg::Matrix<T> result;
+    result.matrix_state = linalg::Format::Dense;
+    result.reshape_dense(col_pointers.empty() ? 0 : col_pointers.size() - 1, X.cols);
+
+    X.sync_dense();
+
+    linalg::kernels::spmm<T, long long>(
+        result.rows, col_pointers.data(), row_indexes.data(), values.data(),
+        X.cols, X.matrix.data(), X.ld, result.matrix.data(), result.ld
+    );
+
+    return result;
 }
 
 #endif // CCS_MATRIX_DECLARE
\ No newline at end of file
@@ -3,33 +3,315 @@
 #ifndef COO_MATRIX_DECLARE
 #define COO_MATRIX_DECLARE
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 #include "../../include/linalg/matrix.hxx"
+#include "../kernels/spmv.hxx"
+
+namespace linalg::detail {
+
+    // Triplet chunk handed to one task during conversion
+    inline constexpr std::size_t COO_CHUNK = 1 << 16;
+
+    // Runs `fn(begin, end)` over [0, n) in chunks of COO_CHUNK on the thread pool
+    template<typename F>
+    void for_each_triplet_chunk(std::size_t n, F&& fn) {
+        std::size_t chunks = (n + COO_CHUNK - 1) / COO_CHUNK;
+
+        linalg::parallel::parallel_for(chunks, [&](std::size_t chunk, std::size_t) {
+            fn(chunk * COO_CHUNK, std::min(n, (chunk + 1) * COO_CHUNK));
+        });
+    }
+
+    // Throws when a triplet lies outside of [0, n_outer) x [0, n_inner).
+    // The shape fields of COO are public and may be shrunk after `add`,
+    // so the converters cannot rely on `add` having grown them.
+    template<typename J>
+    void check_triplet_bounds(std::size_t n_outer, std::size_t n_inner,
+                              const std::vector<J>& outer, const std::vector<J>& inner) {
+        std::size_t nnz = outer.size();
+        auto outside = [&](std::size_t p) {
+            return outer[p] < 0 || inner[p] < 0 ||
+                   static_cast<std::size_t>(outer[p]) >= n_outer || static_cast<std::size_t>(inner[p]) >= n_inner;
+        };
+
+        std::atomic<bool> failed{false};
+
+        if (linalg::parallel::pool().size() > 1 && nnz > COO_CHUNK) {
+            for_each_triplet_chunk(nnz, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t p = begin; p < end; ++p) {
+                    if (outside(p)) {
+                        failed.store(true, std::memory_order_relaxed);
+                        return;
+                    }
+                }
+            });
+        }
+        else {
+            for (std::size_t p = 0; p < nnz && !failed.load(std::memory_order_relaxed); ++p) {
+                if (outside(p)) failed.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        if (!failed.load()) return;
+
+        std::size_t p = 0;
+        while (!outside(p)) ++p;
+
+        bool outer_failed = outer[p] < 0 || static_cast<std::size_t>(outer[p]) >= n_outer;
+
+        std::ostringstream oss;
+        oss << "Triplet " << p << " lies outside of the matrix: index "
+            << (outer_failed ? outer[p] : inner[p]) << " for an extent of " << (outer_failed ? n_outer : n_inner) << ".";
+
+        LINALG_LOG_ERROR(oss.str());
+        throw std::out_of_range(oss.str());
+    }
+
+    // Compresses triplets keyed by (outer, inner) into `ptr` / `idx` / `out_vals`.
+    // Every index is checked against `n_outer` / `n_inner` first.
+    //
+    // 1. Counting sort of the triplets by outer index (atomic cursors)
+    // 2. Per outer slice, sort by (inner, position) and count distinct inner indexes
+    // 3. Prefix sum of the counts, then write (summing duplicates if asked)
+    //
+    // Step 1 moves the whole triplet, so steps 2 and 3 only touch contiguous
+    // memory. Sorting by position as the tie break keeps the result
+    // deterministic regardless of how the scatter interleaved.
+    // `J` is the index type of the triplets, `I` the one of the compressed result.
+    template<typename T, typename J, typename I>
+    void compress_triplets(std::size_t n_outer, std::size_t n_inner,
+                           const std::vector<J>& outer, const std::vector<J>& inner,
+                           const std::vector<T>& vals, bool sum_duplicates,
+                           SparseArray<I>& ptr, SparseArray<I>& idx, SparseArray<T>& out_vals) {
+        struct Entry {
+            I               inner;
+            std::size_t     pos;
+            T               value;
+        };
+
+        linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
+
+        check_triplet_bounds(n_outer, n_inner, outer, inner);
+
+        std::size_t nnz = vals.size();
+        bool parallel = linalg::parallel::pool().size() > 1 && nnz > COO_CHUNK;
+
+        std::vector<I> start(n_outer + 1, 0);
+
+        if (parallel) {
+            for_each_triplet_chunk(nnz, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t p = begin; p < end; ++p) {
+                    std::atomic_ref<I>(start[outer[p] + 1]).fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        else {
+            for (std::size_t p = 0; p < nnz; ++p) ++start[outer[p] + 1];
+        }
+
+        for (std::size_t r = 0; r < n_outer; ++r) start[r + 1] += start[r];
+
+        std::vector<I> cursor(start.begin(), start.end() - 1);
+        std::vector<Entry> entries(nnz);
+
+        if (parallel) {
+            for_each_triplet_chunk(nnz, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t p = begin; p < end; ++p) {
+                    I slot = std::atomic_ref<I>(cursor[outer[p]]).fetch_add(1, std::memory_order_relaxed);
+                    entries[slot] = Entry{static_cast<I>(inner[p]), p, vals[p]};
+                }
+            });
+        }
+        else {
+            for (std::size_t p = 0; p < nnz; ++p) entries[cursor[outer[p]]++] = Entry{static_cast<I>(inner[p]), p, vals[p]};
+        }
+
+        std::vector<I> distinct(n_outer, 0);
+
+        linalg::kernels::for_each_balanced_range(n_outer, start.data(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                auto first = entries.begin() + start[r];
+                auto last = entries.begin() + start[r + 1];
+
+                std::sort(first, last, [](const Entry& a, const Entry& b) {
+                    return a.inner < b.inner || (a.inner == b.inner && a.pos < b.pos);
+                });
+
+                if (!sum_duplicates) {
+                    distinct[r] = last - first;
+                    continue;
+                }
+
+                I count = 0;
+                for (auto it = first; it != last; ++it) {
+                    if (it == first || it->inner != (it - 1)->inner) ++count;
+                }
+                distinct[r] = count;
+            }
+        });
+
+        ptr.assign(n_outer + 1, 0);
+        for (std::size_t r = 0; r < n_outer; ++r) ptr[r + 1] = ptr[r] + distinct[r];
+
+        idx.resize(ptr[n_outer]);
+        out_vals.resize(ptr[n_outer]);
+
+        linalg::metrics::add(linalg::metrics::Counter::conversions);
+        linalg::metrics::add(linalg::metrics::Counter::nnz_touched, nnz);
+        linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                             nnz * sizeof(Entry) + (2 * n_outer + 1) * sizeof(I) +
+                             ptr.size() * sizeof(I) + idx.size() * (sizeof(I) + sizeof(T)));
+
+        linalg::kernels::for_each_balanced_range(n_outer, start.data(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                I out = ptr[r] - 1;
+
+                for (I k = start[r]; k < start[r + 1]; ++k) {
+                    const Entry& entry = entries[k];
+
+                    if (sum_duplicates && k > start[r] && entry.inner == entries[k - 1].inner) {
+                        out_vals[out] += entry.value;
+                        continue;
+                    }
+
+                    ++out;
+                    idx[out] = entry.inner;
+                    out_vals[out] = entry.value;
+                }
+            }
+        });
+    }
+
+}
 
 template<typename T>
 typename linalg::Matrix<T>::COO linalg::Matrix<T>::init_coo(const std::vector<std::vector<T>> _matrix) {
+    linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
     COO mtx;
-    (void)_matrix;
+
+    if (_matrix.empty()) {
+        std::cerr << "Error during `init_coo` operation on line " << __LINE__ << ": Empty matrix.\n";
+        return mtx;
+    }
+
+    mtx.n_rows = _matrix.size();
+    mtx.n_cols = _matrix[0].size();
+
+    for (long long i = 0; i < mtx.n_rows; ++i) {
+        for (long long j = 0; j < mtx.n_cols; ++j) {
+            if (_matrix[i][j] != 0) {
+                mtx.row_indexes.push_back(i);
+                mtx.col_indexes.push_back(j);
+                mtx.values.push_back(_matrix[i][j]);
+            }
+        }
+    }
+
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+    linalg::metrics::add(linalg::metrics::Counter::nnz_touched, mtx.values.size());
+    linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                         mtx.values.size() * (sizeof(T) + 2 * sizeof(long long)));
+
     return mtx;
 }
 
 template<typename T>
-T& linalg::Matrix<T>::COO::operator()(int i, int j) {
-    static T def = static_cast<T>(0);
+const T& linalg::Matrix<T>::COO::operator()(int i, int j) const {
+    for (std::size_t idx = 0; idx < values.size(); ++idx) {
+        if (row_indexes[idx] == i && col_indexes[idx] == j) {
+            return values[idx];
+        }
+    }
+
+    static const T def = static_cast<T>(0);
     return def;
 }
 
 template<typename T>
-const T& linalg::Matrix<T>::COO::operator()(int i, int j) const{
-    static T def = static_cast<T>(0);
-    return def;
+void linalg::Matrix<T>::COO::set(int i, int j, const T& _val) {
+    bool found = false;
+    std::size_t kept = 0;
+
+    // The first triplet at (i, j) takes a nonzero value; later duplicates, or
+    // every triplet there when the value is zero, are dropped as CRS / CCS
+    // erase theirs. The compaction is stable so `operator()` keeps referring
+    // to the first triplet of every other position.
+    for (std::size_t idx = 0; idx < values.size(); ++idx) {
+        if (row_indexes[idx] == i && col_indexes[idx] == j) {
+            if (found || _val == 0) continue;
+
+            values[idx] = _val;
+            found = true;
+        }
+
+        if (kept != idx) {
+            values[kept] = values[idx];
+            row_indexes[kept] = row_indexes[idx];
+            col_indexes[kept] = col_indexes[idx];
+        }
+        ++kept;
+    }
+
+    if (kept != values.size()) {
+        linalg::metrics::add(linalg::metrics::Counter::erases, values.size() - kept);
+
+        values.resize(kept);
+        row_indexes.resize(kept);
+        col_indexes.resize(kept);
+    }
+
+    if (!found && _val != 0) add(i, j, _val);
 }
 
 template<typename T>
-void linalg::Matrix<T>::COO::set(int i, int j, const T& _val) {
-    (void)i;
-    (void)j;
-    (void)_val;
+void linalg::Matrix<T>::COO::add(long long i, long long j, const T& _val) {
+    if (i < 0 || j < 0) {
+        throw std::out_of_range("COO index out of bounds.");
+    }
+
+    row_indexes.push_back(i);
+    col_indexes.push_back(j);
+    values.push_back(_val);
+
+    linalg::metrics::add(linalg::metrics::Counter::inserts);
+
+    if (i >= n_rows) n_rows = i + 1;
+    if (j >= n_cols) n_cols = j + 1;
+}
+
+template<typename T>
+void linalg::Matrix<T>::COO::reserve(std::size_t nnz) {
+    row_indexes.reserve(nnz);
+    col_indexes.reserve(nnz);
+    values.reserve(nnz);
+}
+
+template<typename T>
+typename linalg::Matrix<T>::CRS linalg::Matrix<T>::COO::to_crs(bool sum_duplicates) const {
+    CRS mtx;
+
+    linalg::detail::compress_triplets<T, long long>(
+        n_rows, n_cols, row_indexes, col_indexes, values, sum_duplicates,
+        mtx.row_pointers, mtx.col_indexes, mtx.values
+    );
+
+    return mtx;
+}
+
+template<typename T>
+typename linalg::Matrix<T>::CCS linalg::Matrix<T>::COO::to_ccs(bool sum_duplicates) const {
+    CCS mtx;
+
+    linalg::detail::compress_triplets<T, long long>(
+        n_cols, n_rows, col_indexes, row_indexes, values, sum_duplicates,
+        mtx.col_pointers, mtx.row_indexes, mtx.values
+    );
+
+    return mtx;
 }
 
-#endif // COO_MATRIX_DECLARE
\ No newline at end of file
+#endif // COO_MATRIX_DECLARE
@@ -10,13 +10,13 @@
 
 template<typename T>
 typename linalg::Matrix<T>::CRS linalg::Matrix<T>::init_crs(const std::vector<std::vector<T>> _matrix) {
-    auto logger = spdlog::get("global_logger");
+    linalg::metrics::ScopedTimer timer(linalg::metrics::Timer::conversion);
     CRS mtx;
 
-    logger->debug("Starting initialization of CRS sparse matrix");
+    LINALG_LOG_DEBUG("Starting initialization of CRS sparse matrix");
 
     if (_matrix.empty()) {
-        logger->warn("Error during `init_crs` operation on line {}: Empty matrix.\n", __LINE__);
+        LINALG_LOG_WARN("Error during `init_crs` operation on line {}: Empty matrix.\n", __LINE__);
         std::cerr << "Error during `init_crs` operation on line " << __LINE__ << ": Empty matrix.\n";
         return mtx;
     }
@@ -35,49 +35,28 @@ typename linalg::Matrix<T>::CRS linalg::Matrix<T>::init_crs(const std::vector<st
                 cnt++;
             }
         }
-        logger->debug("Successfully pushed values on iteration index[{}]. Number of elements in row-{}", i, cnt);
+        LINALG_LOG_DEBUG("Successfully pushed values on iteration index[{}]. Number of elements in row-{}", i, cnt);
         mtx.row_pointers.push_back(
                 mtx.row_pointers.back() + cnt
         ); // ROW_INDEX[i] = ROW_INDEX[i-1] + nzc; (nonzero count)
-        logger->debug("Pushed back `row_pointers` value-{}", (mtx.row_pointers.back() + cnt));
+        LINALG_LOG_DEBUG("Pushed back `row_pointers` value-{}", (mtx.row_pointers.back() + cnt));
     }
 
-    logger->info("CRS sparse matrix created successfully. Returning structure");
+    linalg::metrics::add(linalg::metrics::Counter::conversions);
+    linalg::metrics::add(linalg::metrics::Counter::nnz_touched, mtx.values.size());
+    linalg::metrics::add(linalg::metrics::Counter::bytes_allocated,
+                         mtx.values.size() * (sizeof(T) + sizeof(long long)) +
+                         mtx.row_pointers.size() * sizeof(long long));
 
-    return mtx;
-}
-
-template<typename T>
-T& linalg::Matrix<T>::CRS::operator()(int i, int j) {
-    auto logger = spdlog::get("global_logger");
-
-    if (i < 0 || i >= row_pointers.size() - 1) {
-        logger->error("CRS row index-{} out of bounds", i);
-        throw std::out_of_range("CRS row index out of bounds");
-    }
-
-    int row_start = row_pointers[i];
-    int row_end = row_pointers[i + 1];
-
-    for (int idx = row_start; idx < row_end; ++idx) {
-        if (col_indexes[idx] == j) {
-            logger->debug("CRS: Successfully found value at position ({}, {})", i, j);
-            return values[idx];
-        }
-    }
+    LINALG_LOG_INFO("CRS sparse matrix created successfully. Returning structure");
 
-    logger->debug("CRS: Value is zero at position ({}, {}). Returning", i, j);
-    
-    static T def = static_cast<T>(0);
-    return def;
+    return mtx;
 }
 
 template<typename T>
 const T& linalg::Matrix<T>::CRS::operator()(int i, int j) const {
-    auto logger = spdlog::get("global_logger");
-
     if (i < 0 || i >= row_pointers.size() - 1) {
-        logger->error("CRS row index-{} out of bounds", i);
+        LINALG_LOG_ERROR("CRS row index-{} out of bounds", i);
         throw std::out_of_range("CRS row index out of bounds");
     }
 
@@ -86,28 +65,32 @@ const T& linalg::Matrix<T>::CRS::operator()(int i, int j) const {
 
     for (int idx = row_start; idx < row_end; ++idx) {
         if (col_indexes[idx] == j) {
-            logger->debug("CRS: Successfully found value at position ({}, {})", i, j);
+            LINALG_LOG_DEBUG("CRS: Successfully found value at position ({}, {})", i, j);
             return values[idx];
         }
     }
 
-    logger->debug("CRS: Value is zero at position ({}, {}). Returning", i, j);
+    LINALG_LOG_DEBUG("CRS: Value is zero at position ({}, {}). Returning", i, j);
     
-    static T def = static_cast<T>(0);
+    static const T def = static_cast<T>(0);
     return def;
 }
 
 template<typename T>
 void linalg::Matrix<T>::CRS::set(int i, int j, const T& _val) {
-    auto logger = spdlog::get("global_logger");
-
-    logger->debug("Start setting value {} at position ({}, {})", _val, i, j);
+    LINALG_LOG_DEBUG("Start setting value {} at position ({}, {})", _val, i, j);
 
     if (i < 0 || i >= row_pointers.size() - 1) {
-        logger->error("CRS row index out of bounds.");
+        LINALG_LOG_ERROR("CRS row index out of bounds.");
         throw std::out_of_range("CRS row index out of bounds.");
     }
 
+    // The arrays hold no column count, `Matrix::set` checks the upper bound
+    if (j < 0) {
+        LINALG_LOG_ERROR("CRS column index-{} out of bounds", j);
+        throw std::out_of_range("CRS column index out of bounds.");
+    }
+
     int row_start = row_pointers[i];
     int row_end = row_pointers[i + 1];
 
@@ -116,7 +99,7 @@ void linalg::Matrix<T>::CRS::set(int i, int j, const T& _val) {
             if (_val != 0) {
                 values[idx] = _val;
             } else {
-                logger->debug("Value at position idx: {}. Setting it with 0", values[idx]);
+                LINALG_LOG_DEBUG("Value at position idx: {}. Setting it with 0", values[idx]);
 
                 // Value on position (i, j) or in our case (idx) now 0 so we need to erase it from the vector
                 // idx pointing in position (i, j) of current matrix
@@ -126,9 +109,10 @@ void linalg::Matrix<T>::CRS::set(int i, int j, const T& _val) {
                 for (long long k = i + 1; k < row_pointers.size(); ++k) {
                     row_pointers[k]--;
                 }
+
+                linalg::metrics::add(linalg::metrics::Counter::erases);
             }
-            logger->info("CRS: Value set in position: ({}, {})", i, j);
-            logger->flush();
+            LINALG_LOG_INFO("CRS: Value set in position: ({}, {})", i, j);
             return;
         }
         if (col_indexes[idx] > j) break; // Element not found, should insert before this
@@ -138,11 +122,11 @@ void linalg::Matrix<T>::CRS::set(int i, int j, const T& _val) {
     if (_val != 0) {
         int insert_pos = row_start;
 
-        logger->debug("Element yet not exist (0 in position)");
-        logger->debug("Starting `while` loop. Catching infinity-loop error in log");
+        LINALG_LOG_DEBUG("Element yet not exist (0 in position)");
+        LINALG_LOG_DEBUG("Starting `while` loop. Catching infinity-loop error in log");
 
         while (insert_pos < row_end && col_indexes[insert_pos] < j) {
-            logger->debug(
+            LINALG_LOG_DEBUG(
                 "\nIteration:\n" 
                 "Insert position selector: {}\n"
                 "Row end: {}\n"
@@ -162,21 +146,19 @@ void linalg::Matrix<T>::CRS::set(int i, int j, const T& _val) {
         for (long long k = i + 1; k < row_pointers.size(); ++k) {
             row_pointers[k]++;
         }
+
+        linalg::metrics::add(linalg::metrics::Counter::inserts);
     }
 
-    logger->info("CRS: Value set in position: ({}, {})", i, j);
-    logger->flush();
+    LINALG_LOG_INFO("CRS: Value set in position: ({}, {})", i, j);
 }
 
 template<typename T>
-std::string linalg::Matrix<T>::CRS::print() {
-    auto logger = spdlog::get("global_logger");
-
-    logger->debug("Start printing CRS matrix");
+std::string linalg::Matrix<T>::CRS::print() const {
+    LINALG_LOG_DEBUG("Start printing CRS matrix");
 
     if (row_pointers.size() == 0) {
-        logger->error("CRS matrix is empty, can't print");
-        logger->flush();
+        LINALG_LOG_ERROR("CRS matrix is empty, can't print");
 
         std::cerr << "CRS matrix is empty, can't print.\n";
         return "";
@@ -188,7 +170,7 @@ std::string linalg::Matrix<T>::CRS::print() {
     long long max_cols = 0;
 
     for (long long idx = 0; idx < col_indexes.size(); ++idx) {
-        logger->debug(
+        LINALG_LOG_DEBUG(
             "\nCurrent idx: {}\n"
             "Current max_cols: {}\n"
             "Current col_indexes[idx]: {}\n"
@@ -211,25 +193,24 @@ std::string linalg::Matrix<T>::CRS::print() {
 
     temp << "]";
 
-    logger->error(temp.str());
+    LINALG_LOG_DEBUG(temp.str());
 
     max_cols++; // Column index is 0-based, incrementing
 
-    logger->debug("Max_cols variable value {}", max_cols);
-    logger->flush();
+    LINALG_LOG_DEBUG("Max_cols variable value {}", max_cols);
 
     for (long long row = 0; row < row_pointers.size() - 1; ++row) {
         output << "[";
         long long col = 0;
-        logger->debug("Iterating for loop - row {} from {}", row, row_pointers.size());
+        LINALG_LOG_DEBUG("Iterating for loop - row {} from {}", row, row_pointers.size());
 
         // Traverse through each non-zero element in the row
         for (long long idx = row_pointers[row]; idx < row_pointers[row + 1]; ++idx) {
-            logger->debug("idx: {} ; max: {}", idx, row_pointers[row + 1]);
-            logger->debug("Starting `while` loop: iterating through all zero elements");
+            LINALG_LOG_DEBUG("idx: {} ; max: {}", idx, row_pointers[row + 1]);
+            LINALG_LOG_DEBUG("Starting `while` loop: iterating through all zero elements");
 
             if (idx >= col_indexes.size()) {
-                logger->error("Matrix incorrect, column doesn't exist");
+                LINALG_LOG_ERROR("Matrix incorrect, column doesn't exist");
                 std::cerr << "Matrix incorrect, column doesn't exist\n";
 
                 return "";
@@ -237,7 +218,7 @@ std::string linalg::Matrix<T>::CRS::print() {
 
             // Fill zeros for any missing column before the next nonzero symbol
             while (col < col_indexes[idx]) {
-                logger->debug(
+                LINALG_LOG_DEBUG(
                     "\nIteration:\n"
                     "Current column: {}\n"
                     "Current idx: {}\n"
@@ -260,16 +241,16 @@ std::string linalg::Matrix<T>::CRS::print() {
             col++;
 
             if (col > 20) {
-                logger->error("Column `col` too big - {}", col);
+                LINALG_LOG_ERROR("Column `col` too big - {}", col);
                 return "";
             }
         }
         
-        logger->debug("Starting `while` loop, trailling zeros for any remaining column");
+        LINALG_LOG_DEBUG("Starting `while` loop, trailling zeros for any remaining column");
 
         // Fill in trailling zeros for any remaining columns in this row
         while (col < max_cols) {
-            logger->debug(
+            LINALG_LOG_DEBUG(
                 "\nIteration:"
                 "Current column: {}"
                 "Current max_cols: {}",
@@ -281,7 +262,7 @@ std::string linalg::Matrix<T>::CRS::print() {
             col++;
 
             if (col > 20) {
-                logger->error("Column `col` too big - {}", col);
+                LINALG_LOG_ERROR("Column `col` too big - {}", col);
                 return "";
             }
         }
@@ -290,8 +271,37 @@ std::string linalg::Matrix<T>::CRS::print() {
     }
     output << "]";
 
-    logger->info("Matrix:\n" + output.str());
+    LINALG_LOG_INFO("Matrix:\n" + output.str());
     return output.str();
 }
 
+template<typename T>
+std::vector<T> linalg::Matrix<T>::CRS::multiply(const std::vector<T>& x) const {
+    if (row_pointers.empty()) return std::vector<T>();
+
+    std::vector<T> y(row_pointers.size() - 1);
+
+    linalg::kernels::spmv<T, long long>(
+        y.size(), row_pointers.data(), col_indexes.data(), values.data(), x.data(), y.data()
+    );
+
+    return y;
+}
+
+template<typename T>
+linalg::Matrix<T> linalg::Matrix<T>::CRS::multiply(const linalg::Matrix<T>& X) const {
+    linalg::Matrix<T> result;
+    result.matrix_state = linalg::Format::Dense;
+    result.reshape_dense(row_pointers.empty() ? 0 : row_pointers.size() - 1, X.cols);
+
+    X.sync_dense();
+
+    linalg::kernels::spmm<T, long long>(
+        result.rows, row_pointers.data(), col_indexes.data(), values.data(),
+        X.cols, X.matrix.data(), X.ld, result.matrix.data(), result.ld
+    );
+
+    return result;
+}
+
 #endif // CRS_MATRIX_DECLARE
\ No newline at end of file
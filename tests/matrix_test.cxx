@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "matrix.hxx"
+
+// Element access of the runtime-dispatched matrix in every format.
+// Exits with the number of failed checks.
+
+namespace {
+
+    using T = double;
+    using linalg::Format;
+
+    constexpr Format STATES[] = {Format::Dense, Format::CRS, Format::CCS, Format::COO, Format::All};
+
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        std::printf("%-44s %s\n", what.c_str(), ok ? "ok" : "FAILED");
+        if (!ok) ++failures;
+    }
+
+    template<typename Error, typename Fn>
+    bool throws(Fn&& fn) {
+        try {
+            fn();
+        }
+        catch (const Error&) {
+            return true;
+        }
+        catch (...) {
+        }
+        return false;
+    }
+
+    // Every index outside the 2 x 3 matrix is rejected by `get` and `set`
+    // and leaves the matrix (and the formats built from it) unchanged
+    void bounds(Format state) {
+        std::string name = linalg::format_name(state);
+        linalg::Matrix<T> A({{1, 0, 2}, {0, 3, 0}}, state);
+
+        const int outside[][2] = {{0, 3}, {0, 5}, {2, 0}, {-1, 0}, {0, -1}, {5, 5}};
+        bool rejected = true;
+        for (const auto& [i, j] : outside) {
+            rejected = throws<std::out_of_range>([&] { A.set(i, j, 1); }) && rejected;
+            rejected = throws<std::out_of_range>([&] { (void)A.get(i, j); }) && rejected;
+        }
+        check(rejected, name + ": out-of-shape get / set throw");
+
+        std::vector<T> y = A.transpose_multiply({1, 1});
+        check(A.ccs().values.size() == 3 && y == std::vector<T>{1, 3, 2}, name + ": formats unchanged");
+    }
+
+
+    // Setting an entry to zero removes it in every format, so repeated
+    // insert / erase pairs keep the stored and cached nonzero counts fixed
+    void zeros(Format state) {
+        std::string name = linalg::format_name(state);
+        linalg::Matrix<T> A({{1, 0, 2}, {0, 3, 0}}, state);
+
+        for (int round = 0; round < 3; ++round) {
+            A.set(1, 0, 4);
+            A.set(1, 0, 0);
+            A.set(0, 2, 0);
+            A.set(0, 2, 2);
+        }
+
+        check(A.crs().values.size() == 3 && A.ccs().values.size() == 3 && A.coo().values.size() == 3,
+              name + ": zeroed entries are erased");
+        check(A.get(1, 0) == 0 && A.get(0, 2) == 2, name + ": values after erase");
+    }
+
+    // A size line declaring more entries than the file can hold is a parse
+    // error, not an attempt to reserve them
+    void matrix_market() {
+        auto path = (std::filesystem::temp_directory_path() / "linalg_matrix_test.mtx").string();
+        auto read = [&](const std::string& text) {
+            std::ofstream(path, std::ios::binary) << text;
+            return linalg::Matrix<T>::read_matrix_market(path, "CRS");
+        };
+
+        check(read("%%MatrixMarket matrix coordinate real general\n2 2 2\n1 1 1\n2 2 2").crs().values.size() == 2,
+              "matrix market: shortest entry lines");
+        check(read("%%MatrixMarket matrix coordinate pattern symmetric\n2 2 2\n1 1\n2 1").crs().values.size() == 3,
+              "matrix market: shortest pattern lines");
+        check(throws<std::runtime_error>([&] {
+                  read("%%MatrixMarket matrix coordinate real general\n1 1 4000000000000\n1 1 1\n");
+              }), "matrix market: impossible entry count");
+        check(throws<std::runtime_error>([&] {
+                  read("%%MatrixMarket matrix coordinate real symmetric\n1 1 9223372036854775807\n");
+              }), "matrix market: overflowing entry count");
+
+        std::filesystem::remove(path);
+    }
+
+}
+
+int main() {
+    for (Format state : STATES) bounds(state);
+    for (Format state : STATES) zeros(state);
+    matrix_market();
+
+    return failures;
+}
@@ -0,0 +1,141 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "solvers.hxx"
+
+// Solves 2-D model problems with every solver / preconditioner pair and checks
+// the true residual ||b - A x|| / ||b|| against the tolerance.
+// Exits with the number of failed checks.
+
+namespace {
+
+    using T = double;
+    using linalg::Format;
+    namespace solvers = linalg::solvers;
+
+    constexpr T TOLERANCE = 1e-8;
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        std::printf("%-44s %s\n", what.c_str(), ok ? "ok" : "FAILED");
+        if (!ok) ++failures;
+    }
+
+    // 5-point stencil on a k x k grid: Poisson for convection = 0 (SPD),
+    // upwinded convection-diffusion (nonsymmetric) otherwise
+    linalg::Matrix<T>::COO grid(int k, T convection) {
+        linalg::Matrix<T>::COO coo;
+        coo.reserve(5 * static_cast<std::size_t>(k) * k);
+
+        for (int i = 0; i < k; ++i) {
+            for (int j = 0; j < k; ++j) {
+                long long row = static_cast<long long>(i) * k + j;
+
+                if (i > 0)     coo.add(row, row - k, -1 - convection);
+                if (j > 0)     coo.add(row, row - 1, -1 - convection);
+                coo.add(row, row, 4);
+                if (j < k - 1) coo.add(row, row + 1, -1 + convection);
+                if (i < k - 1) coo.add(row, row + k, -1 + convection);
+            }
+        }
+
+        coo.n_rows = coo.n_cols = static_cast<long long>(k) * k;
+        return coo;
+    }
+
+    template<typename A_t>
+    T true_residual(const A_t& A, const std::vector<T>& b, const std::vector<T>& x) {
+        auto view = solvers::csr_view<T>(A);
+        std::vector<T> ax(b.size());
+        view.multiply(x.data(), ax.data());
+
+        T r = 0, norm = 0;
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            r += (b[i] - ax[i]) * (b[i] - ax[i]);
+            norm += b[i] * b[i];
+        }
+        return std::sqrt(r / norm);
+    }
+
+    template<typename A_t, typename Solve>
+    void expect_solved(const std::string& name, const A_t& A, const std::vector<T>& b, Solve&& solve) {
+        std::vector<T> x;
+        auto result = solve(x);
+
+        check(result.converged() && true_residual(A, b, x) <= TOLERANCE, name);
+    }
+
+    // Every preconditioner with one solver; `solve(x, M, options)` runs it on A x = b
+    template<typename A_t, typename Solver>
+    void each_preconditioner(const std::string& name, const A_t& A, const std::vector<T>& b, Solver&& solve,
+                             bool symmetric) {
+        solvers::SolverOptions<T> options;
+        options.tolerance = TOLERANCE;
+        options.max_iterations = 2000;
+
+        expect_solved(name, A, b, [&](std::vector<T>& x) {
+            return solve(x, solvers::Identity<T>(), options);
+        });
+        expect_solved(name + " + Jacobi", A, b, [&](std::vector<T>& x) {
+            return solve(x, solvers::Jacobi<T>(A), options);
+        });
+        expect_solved(name + " + ILU(0)", A, b, [&](std::vector<T>& x) {
+            return solve(x, solvers::ILU0<T>(A), options);
+        });
+        if (symmetric) {
+            expect_solved(name + " + IC(0)", A, b, [&](std::vector<T>& x) {
+                return solve(x, solvers::IC0<T>(A), options);
+            });
+        }
+    }
+
+}
+
+int main() {
+    constexpr int k = 48;
+    std::vector<T> b(static_cast<std::size_t>(k) * k, static_cast<T>(1));
+
+    linalg::Matrix<T, Format::CRS, long long> poisson(grid(k, 0));
+    linalg::Matrix<T, Format::CRS, std::int32_t> convection(grid(k, 0.3));
+
+    each_preconditioner("poisson: CG", poisson, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::cg(poisson, b, x, M, options);
+    }, true);
+    each_preconditioner("poisson: BiCGSTAB", poisson, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::bicgstab(poisson, b, x, M, options);
+    }, true);
+    each_preconditioner("poisson: GMRES", poisson, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::gmres(poisson, b, x, M, options);
+    }, true);
+
+    // 32-bit indexes, read in place
+    each_preconditioner("convection: BiCGSTAB", convection, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::bicgstab(convection, b, x, M, options);
+    }, false);
+    each_preconditioner("convection: GMRES", convection, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::gmres(convection, b, x, M, options);
+    }, false);
+
+    // The dynamic matrix solves through its cached CRS
+    linalg::Matrix<T> dynamic(grid(k, 0), Format::COO);
+    each_preconditioner("dynamic COO: CG", dynamic, b, [&](auto& x, const auto& M, const auto& options) {
+        return solvers::cg(dynamic, b, x, M, options);
+    }, true);
+
+    // A callback returning false on the converging iteration keeps `converged`
+    {
+        solvers::SolverOptions<T> options;
+        options.tolerance = TOLERANCE;
+        options.on_iteration = [](const solvers::IterationInfo<T>& info) {
+            return info.relative_residual > TOLERANCE;
+        };
+
+        std::vector<T> x;
+        auto result = solvers::cg(poisson, b, x, solvers::IC0<T>(poisson), options);
+        check(result.status == solvers::SolverStatus::converged, "callback on the converging iteration");
+    }
+
+    return failures;
+}